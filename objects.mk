@@ -4,5 +4,5 @@
 
 USER_OBJS :=
 
-LIBS := -ldl
+LIBS := -ldl -pthread
 
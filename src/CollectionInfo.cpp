@@ -147,7 +147,7 @@ void CollectionInfo::saveCollectionInfo() {
 	}
 	fprintf(info_file, "#%lu\n", colors.size());
 	for(auto it = colors.begin(); it != colors.end(); ++it) {
-		fprintf(info_file, "%lu\t%lu\n", it->first, it->second);
+		fprintf(info_file, "%lu\t%lu\n", (LetterNumber) it->first, (LetterNumber) it->second);
 	}
 
 	fclose(info_file);
@@ -167,21 +167,23 @@ void CollectionInfo::loadCollectionInfo(std::string file_name) {
 		Error::stopWithError(C_CollectionInfo_ClassName, __func__, err_message.str());
 	}
 
+	// Counters are read as LetterNumber, whatever the width of their type
 	fscanf(info_file, "%lu\n", &size);
-	AlphabetSize alpha = 0;
+	LetterNumber alpha = 0;
 	fscanf(info_file, "#%lu\n", &alpha);
-	AlphabetSymbol symbol = '\0';
+	char symbol = '\0';
 	LetterNumber frequency = 0;
-	for(AlphabetSize i = 0; i < alpha; ++i) {
+	for(LetterNumber i = 0; i < alpha; ++i) {
 		fscanf(info_file, "%c\t%lu\n", &symbol, &frequency);
 		freq.insert(pair<AlphabetSymbol, LetterNumber>(symbol, frequency));
 	}
-	SequenceNumber seqs_num = 0;
+	LetterNumber seqs_num = 0;
 	fscanf(info_file, "#%lu\n", &seqs_num);
-	SequenceNumber color = 0;
-	SequenceLength length = 0;
-	for(SequenceNumber i = 0; i < seqs_num; ++i) {
+	LetterNumber color = 0;
+	LetterNumber length = 0;
+	for(LetterNumber i = 0; i < seqs_num; ++i) {
 		fscanf(info_file, "%lu\t%lu\n", &color, &length);
+		checkWidths(color, length);
 		colors.insert(pair<SequenceNumber, SequenceLength>(color, length));
 	}
 
@@ -207,6 +209,7 @@ void CollectionInfo::loadCollectionLengths(std::string info_file_name) {
 		vector<int_lcp> len_buffer(BUFFER_SIZE, 0);
 		while((num_read = fread(&len_buffer[0], sizeof(int_lcp), len_buffer.size() , len_file)) > 0) {
 			for(LetterNumber i = 0; i < num_read; ++i) {
+				checkWidths(color, (LetterNumber) len_buffer[i] + 1);
 				colors.insert(pair<SequenceNumber, SequenceLength>(color, len_buffer[i] + 1));
 				++color;
 				size += len_buffer[i] + 1;
@@ -317,6 +320,7 @@ void CollectionInfo::collectColorsInfo(FILE* file) {
 	while((num_read = fread(buffer, sizeof(SequenceNumber), BUFFER_SIZE, file)) > 0) {
 		for(LetterNumber i = 0; i < num_read; ++i) {
 			if(colors.count(buffer[i]) > 0) {
+				checkWidths(buffer[i], (LetterNumber) colors[buffer[i]] + 1);
 				++colors[buffer[i]];
 			} else {
 				colors.insert(pair<SequenceNumber, SequenceLength>(buffer[i], 1));
@@ -331,23 +335,38 @@ void CollectionInfo::collectSymbolsAndColorsInfo(FILE* file) {
 	t_GSA buffer[BUFFER_SIZE];
 	LetterNumber num_read = 0;
 	while((num_read = fread(buffer, sizeof(t_GSA), BUFFER_SIZE, file)) > 0) {
-		size += num_read;
-		for(LetterNumber i = 0; i < num_read; ++i) {
-			if(freq.count(buffer[i].bwt) > 0) {
-				++freq[buffer[i].bwt];
-			} else {
-				freq.insert(pair<AlphabetSymbol, LetterNumber>(buffer[i].bwt, 1));
-			}
-			if(colors.count(buffer[i].text) > 0) {
-				++colors[buffer[i].text];
-			} else {
-				colors.insert(pair<SequenceNumber, SequenceLength>(buffer[i].text, 1));
-			}
-		}
+		for(LetterNumber i = 0; i < num_read; ++i)
+			collectGESAStruct(buffer[i]);
 	}
 
 }
 
+void CollectionInfo::collectGESAStruct(const t_GSA &gesa_struct) {
+	++size;
+	++freq[gesa_struct.bwt];
+	if(gesa_struct.text >= C_MaxSequenceNumber)
+		checkWidths(gesa_struct.text, 0);
+	SequenceLength &length = colors[gesa_struct.text];
+	if(length == C_MaxSequenceLength - 1)
+		checkWidths(gesa_struct.text, (LetterNumber) length + 1);
+	++length;
+}
+
+// Colors and lengths have to fit the widths of the build (Types.h), the
+// largest values being kept as sentinels
+void CollectionInfo::checkWidths(const LetterNumber color, const LetterNumber length) {
+	if(color < C_MaxSequenceNumber && length < C_MaxSequenceLength)
+		return;
+	ostringstream err_message;
+	if(color >= C_MaxSequenceNumber)
+		err_message << "Sequence " << color << " exceeds the " << MULTI_ACS_COLOR_BITS
+				<< "-bit colors of this build (MULTI_ACS_COLOR_BITS)";
+	else
+		err_message << "Sequence " << color << " of length " << length << " exceeds the "
+				<< MULTI_ACS_LCP_BITS << "-bit lengths of this build (MULTI_ACS_LCP_BITS)";
+	Error::stopWithError(C_CollectionInfo_ClassName, __func__, err_message.str());
+}
+
 void CollectionInfo::join(const CollectionInfo& collection) {
 
 	size += collection.size;
@@ -358,7 +377,7 @@ void CollectionInfo::join(const CollectionInfo& collection) {
 			freq.insert(pair<AlphabetSymbol, LetterNumber>(freq_pair.first, freq_pair.second));
 		}
 	}
-	SequenceLength sequence_number = colors.size();
+	SequenceNumber sequence_number = colors.size();
 	for(const pair<SequenceNumber, SequenceLength> &colors_pair : collection.colors) {
 		if(colors.count(colors_pair.first) > 0) {
 			colors.insert(pair<SequenceNumber, SequenceLength>(colors_pair.first + sequence_number, colors_pair.second));
@@ -77,6 +77,8 @@ public:
 	void loadCollectionLengths(std::string info_file_name);
 
 	void join(const CollectionInfo &collection);
+	// Symbol and color of one suffix, for a scan of the GESA done elsewhere
+	void collectGESAStruct(const t_GSA &gesa_struct);
 
 private:
 	const std::string collection_file_name;
@@ -90,6 +92,7 @@ private:
 	void collectSymbolsInfo(FILE* file);
 	void collectColorsInfo(FILE* file);
 	void collectSymbolsAndColorsInfo(FILE* file);
+	static void checkWidths(const LetterNumber color, const LetterNumber length);
 };
 
 } /* namespace multi_acs */
@@ -0,0 +1,401 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "ForwardScanner.h"
+#include "Types.h"
+#include "Reader.h"
+#include "RowKernels.h"
+#include "MemoryGovernor.h"
+#include "Tools.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+
+using namespace std;
+
+namespace multi_acs {
+
+ForwardScanner::ForwardScanner(const SequenceNumber reference_color,
+		const SequenceNumber m,
+		const SequenceLength n_x,
+		const SequenceLength Q,
+		LCPSource &lcp_x_reader,
+		FILE* cLCP_x_file,
+		LetterNumber score_r[],
+		const bool verbose) :
+	ForwardScanner(reference_color, m, n_x, Q, lcp_x_reader,
+			cLCP_x_file, nullptr, nullptr, score_r, verbose) { }
+
+ForwardScanner::ForwardScanner(const SequenceNumber reference_color,
+		const SequenceNumber m,
+		const SequenceLength n_x,
+		const SequenceLength Q,
+		LCPSource &lcp_x_reader,
+		SparseCLCPWriter &cLCP_x_writer,
+		LetterNumber score_r[],
+		const bool verbose) :
+	ForwardScanner(reference_color, m, n_x, Q, lcp_x_reader,
+			nullptr, &cLCP_x_writer, nullptr, score_r, verbose) { }
+
+ForwardScanner::ForwardScanner(const SequenceNumber reference_color,
+		const SequenceNumber m,
+		const SequenceLength n_x,
+		const SequenceLength Q,
+		LCPSource &lcp_x_reader,
+		CLCPCheckpointWriter &checkpoint_writer,
+		LetterNumber score_r[],
+		const bool verbose) :
+	ForwardScanner(reference_color, m, n_x, Q, lcp_x_reader,
+			nullptr, nullptr, &checkpoint_writer, score_r, verbose) { }
+
+ForwardScanner::ForwardScanner(const SequenceNumber reference_color,
+		const SequenceNumber m,
+		const SequenceLength n_x,
+		const SequenceLength Q,
+		LCPSource &lcp_x_reader,
+		FILE* cLCP_x_file,
+		SparseCLCPWriter* cLCP_x_writer,
+		CLCPCheckpointWriter* checkpoint_writer,
+		LetterNumber score_r[],
+		const bool verbose) :
+	reference_color(reference_color),
+	m(m),
+	n_x(n_x),
+	Q(Q),
+	lcp_x_reader(lcp_x_reader),
+	cLCP_x_file(cLCP_x_file),
+	cLCP_x_writer(cLCP_x_writer),
+	checkpoint_writer(checkpoint_writer),
+	score_r(score_r),
+	verbose(verbose),
+	keep_rows(cLCP_x_file != nullptr || cLCP_x_writer != nullptr
+			|| checkpoint_writer != nullptr || score_r == nullptr),
+	lazy_rows(checkpoint_writer != nullptr && !verbose),
+	cLCP_x(keep_rows && !lazy_rows ? Q + 1 : 0, m),
+	touched_stamps(keep_rows ? m : 0, 0),
+	last_values(lazy_rows ? m : 0, 0),
+	last_refs(lazy_rows ? m : 0, 0),
+	pending_values(lazy_rows ? m : 0, 0) {
+	if(cLCP_x.data() != nullptr && (cLCP_x_file != nullptr || cLCP_x_writer != nullptr))
+		written_page.allocate(Q + 1, m);
+}
+
+ForwardScanner::~ForwardScanner() {
+	waitWriter();
+}
+
+void ForwardScanner::begin() {
+	waitWriter();
+	zeroRows(cLCP_x.data(), cLCP_x.size());
+	resetTouched();
+	h_x = 0;
+	h_x_idx = 0;
+	alpha = C_MaxSequenceLength;
+	k = 0;
+	position = 0;
+	lcp_x_reader.readLCPValue(lcp_x_value);
+}
+
+void ForwardScanner::resume(const SequenceLength h, const SequenceLength row_h[]) {
+	waitWriter();
+	zeroRows(cLCP_x.data(), cLCP_x.size());
+	resetTouched();
+	if(keep_rows && row_h != nullptr)
+		copy(row_h, row_h + m, lazy_rows ? last_values.data() : row(0));
+	if(lazy_rows)
+		fill(last_refs.begin(), last_refs.end(), h);
+	h_x = h;
+	h_x_idx = 0;
+	nextReferenceSuffix();
+}
+
+// First suffix of color id since the last reference suffix
+void ForwardScanner::touchColor(const SequenceNumber id) {
+	touched_stamps[id] = h_x + 1;
+	if(lazy_rows) {
+		touched.push_back(id);
+		if(h_x > 0) {
+			last_values[id] = max(lazyValue(id), alpha);
+			last_refs[id] = h_x - 1;
+		}
+	}
+	else if(h_x > 0) {
+		SequenceLength* prev_row = row(h_x_idx - 1);
+		if(alpha > prev_row[id])
+			prev_row[id] = alpha;
+	}
+}
+
+// The row of the reference suffix is merged into the next one
+void ForwardScanner::referenceSuffix() {
+	if(lazy_rows) {
+		mergeTouched();
+	}
+	else if(h_x > 0 && keep_rows) {
+		SequenceLength* cur_row = row(h_x_idx);
+		maxMinRow(cur_row, row(h_x_idx - 1), lcp_x_value, cur_row, m);
+	}
+	nextReferenceSuffix();
+}
+
+void ForwardScanner::nextReferenceSuffix() {
+	++h_x;
+	alpha = C_MaxSequenceLength;
+	k = 0;
+
+	if(!lcp_x_reader.readLCPValue(lcp_x_value))
+		lcp_x_value = 0;
+
+	if(!keep_rows)
+		return;
+
+	++h_x_idx;
+	if(h_x_idx == Q + 1) {
+		h_x_idx = 1;
+		if(lazy_rows) {
+			materializeRow();
+			checkpoint_writer->writeCheckpoint(h_x - 1, position, last_values.data());
+			return;
+		}
+		if(written_page.data() != nullptr) {
+			// The scan goes on in the page zeroed by the writer thread
+			waitWriter();
+			copy(row(Q), row(Q) + m, written_page.row(0));
+			cLCP_x.swap(written_page);
+			writer = thread(&ForwardScanner::writePage, this);
+		}
+		else {
+			if(!writeRows(cLCP_x, Q))
+				Error::stopWithError(C_ForwardScanner_ClassName, __func__, "Couldn't write a page of the partial cLCP");
+			copy(row(Q), row(Q) + m, row(0));
+			zeroRows(row(1), (LetterNumber) Q*m);
+		}
+		if(checkpoint_writer != nullptr)
+			checkpoint_writer->writeCheckpoint(h_x - 1, position, row(0));
+		if(relief != nullptr) {
+			relief->checkCeiling(C_ForwardScanner_ClassName, __func__);
+			followRelief();
+		}
+		else if(MemoryGovernor::underPressure()) {
+			MemoryGovernor::checkCeiling(C_ForwardScanner_ClassName, __func__);
+		}
+	}
+}
+
+size_t PageRelief::join(const bool written_page, const SequenceLength page_rows) {
+	lock_guard<mutex> lock(relief_mutex);
+	written.push_back(written_page);
+	rows.push_back(page_rows);
+	return rows.size() - 1;
+}
+
+void PageRelief::hold(const size_t slot, const bool written_page, const SequenceLength page_rows) {
+	lock_guard<mutex> lock(relief_mutex);
+	written[slot] = written_page;
+	rows[slot] = page_rows;
+}
+
+bool PageRelief::shrinks(const SequenceLength page_rows, const SequenceLength target) const {
+	return page_rows > target
+			&& PageArena::mappedBytes(target + 1, m) < PageArena::mappedBytes(page_rows + 1, m);
+}
+
+/* A step still followed by some scanner is not counted again, and the
+ * pages are halved only when that shrinks the mapping of the deepest one.
+ */
+bool PageRelief::relieve() {
+	lock_guard<mutex> lock(relief_mutex);
+	bool pending = false;
+	for(size_t slot = 0; slot < rows.size(); ++slot) {
+		if(written[slot]) {
+			if(!release_written) {
+				release_written = true;
+				MemoryGovernor::relieved();
+				return true;
+			}
+			pending = true;
+		}
+	}
+	SequenceLength deepest = 0;
+	for(const SequenceLength page_rows : rows) {
+		pending = pending || shrinks(page_rows, depth);
+		deepest = max(deepest, page_rows);
+	}
+	if(pending)
+		return true;
+	for(SequenceLength half = min(deepest, depth)/2; half >= 1; half /= 2) {
+		if(shrinks(deepest, half)) {
+			depth = half;
+			MemoryGovernor::relieved();
+			return true;
+		}
+	}
+	return false;
+}
+
+void PageRelief::checkCeiling(const char* class_name, const char* caller) {
+	if(!MemoryGovernor::underPressure() || !relieve())
+		MemoryGovernor::checkCeiling(class_name, caller);
+}
+
+void PageRelief::requested(bool &release, SequenceLength &target) {
+	lock_guard<mutex> lock(relief_mutex);
+	release = release_written;
+	target = depth;
+}
+
+void ForwardScanner::setRelief(PageRelief &page_relief) {
+	relief = &page_relief;
+	relief_slot = relief->join(written_page.data() != nullptr, halvable() ? Q : 0);
+}
+
+/* The tiles and the checkpoints keep the rows of their pages, which the
+ * backward computation follows.
+ */
+bool ForwardScanner::halvable() const {
+	return tile_width == 0 && checkpoint_writer == nullptr && cLCP_x.data() != nullptr
+			&& (cLCP_x_file != nullptr || cLCP_x_writer != nullptr);
+}
+
+// The page drained by the writer thread is released, the following pages
+// being written by the scan itself, and the pages are halved
+void ForwardScanner::followRelief() {
+	bool release_written;
+	SequenceLength depth;
+	relief->requested(release_written, depth);
+	if(release_written && written_page.data() != nullptr) {
+		waitWriter();
+		written_page.release();
+	}
+	if(written_page.data() == nullptr && halvable() && relief->shrinks(Q, depth)) {
+		PageArena page(depth + 1, m);
+		copy(row(0), row(0) + m, page.row(0));
+		cLCP_x.swap(page);
+		Q = depth;
+	}
+	relief->hold(relief_slot, written_page.data() != nullptr, halvable() ? Q : 0);
+}
+
+void ForwardScanner::resetTouched() {
+	fill(touched_stamps.begin(), touched_stamps.end(), 0);
+	touched.clear();
+	fill(last_values.begin(), last_values.end(), 0);
+	fill(last_refs.begin(), last_refs.end(), 0);
+	fill(pending_values.begin(), pending_values.end(), 0);
+	lcp_x_minima.clear();
+}
+
+// Value of color r in the row of the last reference suffix
+SequenceLength ForwardScanner::lazyValue(const SequenceNumber r) const {
+	auto it = upper_bound(lcp_x_minima.begin(), lcp_x_minima.end(),
+			make_pair(last_refs[r], C_MaxSequenceLength));
+	return (it == lcp_x_minima.end()) ? last_values[r] : min(last_values[r], it->second);
+}
+
+// Row of the reference suffix h_x, for the touched colors
+void ForwardScanner::mergeTouched() {
+	if(h_x > 0) {
+		while(!lcp_x_minima.empty() && lcp_x_minima.back().second >= lcp_x_value)
+			lcp_x_minima.pop_back();
+		lcp_x_minima.push_back(make_pair(h_x, lcp_x_value));
+	}
+	for(const SequenceNumber id : touched) {
+		last_values[id] = (h_x > 0) ? max(min(last_values[id], lcp_x_value), pending_values[id])
+				: pending_values[id];
+		last_refs[id] = h_x;
+		pending_values[id] = 0;
+	}
+	touched.clear();
+}
+
+// Every color takes its value in the row of the last reference suffix
+void ForwardScanner::materializeRow() {
+	for(SequenceNumber r = 0; r < m; ++r) {
+		last_values[r] = lazyValue(r);
+		last_refs[r] = h_x - 1;
+	}
+	lcp_x_minima.clear();
+}
+
+// Write the rows of the current page
+void ForwardScanner::flushPage() {
+	waitWriter();
+	if(!writeRows(cLCP_x, h_x_idx))
+		Error::stopWithError(C_ForwardScanner_ClassName, __func__, "Couldn't write the last page of the partial cLCP");
+	if(cLCP_x_writer != nullptr)
+		cLCP_x_writer->flushCLCPRows();
+}
+
+// Write the full page handed to the writer thread, and zero it
+void ForwardScanner::writePage() {
+	write_failed = !writeRows(written_page, Q);
+	zeroRows(written_page.data(), written_page.size());
+}
+
+void ForwardScanner::waitWriter() {
+	if(writer.joinable())
+		writer.join();
+	if(write_failed)
+		Error::stopWithError(C_ForwardScanner_ClassName, __func__, "Couldn't write a page of the partial cLCP");
+}
+
+// Write the first rows of the page, false if the write failed
+bool ForwardScanner::writeRows(const PageArena &page, const SequenceLength rows) {
+	if(cLCP_x_file == nullptr && cLCP_x_writer == nullptr)
+		return true;
+	if(cLCP_x_writer != nullptr)
+		return cLCP_x_writer->writeCLCPRows(page.row(0), rows);
+	const LetterNumber values = (LetterNumber) rows*m;
+	if(tile_width > 0) {
+		if(tiles.data() == nullptr)
+			tiles.allocate(Q, m);
+		SequenceLength* tile = tiles.data();
+		for(SequenceNumber c = 0; c < m; c += tile_width) {
+			const SequenceNumber width = min<SequenceNumber>(tile_width, m - c);
+			for(SequenceLength i = 0; i < rows; ++i, tile += width)
+				copy(page.row(i) + c, page.row(i) + c + width, tile);
+		}
+		return fwrite(tiles.data(), sizeof(SequenceLength), values, cLCP_x_file) == values;
+	}
+	return fwrite(page.row(0), sizeof(SequenceLength), values, cLCP_x_file) == values;
+}
+
+} /* namespace multi_acs */
@@ -0,0 +1,327 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#ifndef FORWARDSCANNER_H_
+#define FORWARDSCANNER_H_
+
+#include "Types.h"
+#include "Reader.h"
+#include "Writer.h"
+#include "PageArena.h"
+#include "RowKernels.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <mutex>
+
+namespace multi_acs {
+
+const char C_ForwardScanner_ClassName[]{"ForwardScanner"};
+
+// Range of the target collection processed by one worker of the parallel
+// forward computation
+struct ForwardChunk {
+	// First suffix (a reference suffix, except for the first chunk)
+	LetterNumber start{0};
+	LetterNumber end{0};
+	// Index of the reference suffix at start
+	SequenceLength h{0};
+	// Number of reference suffixes in the chunk
+	SequenceLength refs{0};
+	// lcp_x[h] and min(lcp_x[h+1], ..., lcp_x[h+refs-1])
+	SequenceLength first_lcp_x{0};
+	SequenceLength min_lcp_x{C_MaxSequenceLength};
+	// Rows computed starting from a zero row
+	std::vector<SequenceLength> last_row;
+	std::vector<SequenceLength> pending_row;
+	// Row h propagated from the previous chunks
+	std::vector<SequenceLength> carry;
+	std::vector<LetterNumber> score_r;
+};
+
+// Memory given back under pressure by the scanners of a forward block,
+// which may be split among several threads. The pages drained by the
+// writer threads are released first, then the pages are halved until
+// their mapping shrinks; every scanner follows at its page boundaries.
+class PageRelief {
+public:
+	explicit PageRelief(const SequenceNumber m) : m(m) { }
+	// Slot of a scanner, holding a written page or not, and pages of the
+	// given rows that can be halved (0 if they can't)
+	size_t join(const bool written, const SequenceLength rows);
+	void hold(const size_t slot, const bool written, const SequenceLength rows);
+	// Next step of relief for the block, false if no scanner has anything
+	// left to give back
+	bool relieve();
+	// Checks the ceiling after a block of the scan, which stops only when
+	// nothing is left to give back
+	void checkCeiling(const char* class_name, const char* caller);
+	// Steps a scanner has to follow
+	void requested(bool &release_written, SequenceLength &depth);
+	// Whether pages of the given rows shrink at depth rows
+	bool shrinks(const SequenceLength rows, const SequenceLength depth) const;
+
+private:
+	const SequenceNumber m;
+	std::mutex relief_mutex;
+	bool release_written{false};
+	SequenceLength depth{C_MaxSequenceLength};
+	std::vector<bool> written;
+	std::vector<SequenceLength> rows;
+};
+
+// Forward computation of the partial cLCP for one reference color.
+// Suffixes of the target collection are given one at a time in GSA order,
+// and the rows of the partial cLCP are written to cLCP_x_file, or to a
+// sparse cLCP, one page (Q rows) at a time. With a checkpoint writer only the
+// first row of every page is written. Without cLCP_x_file only score_r is
+// computed, and without score_r either the rows are just kept in memory
+// (getRow) until the page is full.
+// Only the colors touched since the last reference suffix are updated by
+// the following one: with a checkpoint writer the rows are not stored, and
+// a color not touched keeps its last value, bounded by the minimum lcp_x
+// of the reference suffixes since then, until the row of a checkpoint is
+// materialized.
+class ForwardScanner {
+public:
+	ForwardScanner(const SequenceNumber reference_color,
+			const SequenceNumber m,
+			const SequenceLength n_x,
+			const SequenceLength Q,
+			LCPSource &lcp_x_reader,
+			FILE* cLCP_x_file,
+			LetterNumber score_r[],
+			const bool verbose = false);
+	ForwardScanner(const SequenceNumber reference_color,
+			const SequenceNumber m,
+			const SequenceLength n_x,
+			const SequenceLength Q,
+			LCPSource &lcp_x_reader,
+			SparseCLCPWriter &cLCP_x_writer,
+			LetterNumber score_r[],
+			const bool verbose = false);
+	ForwardScanner(const SequenceNumber reference_color,
+			const SequenceNumber m,
+			const SequenceLength n_x,
+			const SequenceLength Q,
+			LCPSource &lcp_x_reader,
+			CLCPCheckpointWriter &checkpoint_writer,
+			LetterNumber score_r[],
+			const bool verbose = false);
+	~ForwardScanner();
+
+	// Start from the first suffix of the collection
+	void begin();
+	// Start right after the h-th reference suffix, whose row (before the
+	// contribution of the following suffixes) is given.
+	// lcp_x_reader has to be positioned on the (h+1)-th value.
+	void resume(const SequenceLength h, const SequenceLength row[]);
+	// The values and rows are traced by the Trace policy (Writer.h), which
+	// needs the rows to be stored (verbose)
+	template<class Trace>
+	void processSuffix(const SequenceNumber id,
+			const SequenceLength lcp_value,
+			const SequenceLength d_value,
+			Trace &trace);
+	void processSuffix(const SequenceNumber id,
+			const SequenceLength lcp_value,
+			const SequenceLength d_value) {
+		NoTrace no_trace;
+		processSuffix(id, lcp_value, d_value, no_trace);
+	}
+	// Write the rows of the reference suffixes processed so far
+	template<class Trace>
+	void flushRows(Trace &trace);
+	void flushRows() {
+		NoTrace no_trace;
+		flushRows(no_trace);
+	}
+
+	// Number of reference suffixes processed so far
+	SequenceLength getReferenceSuffixes() const { return h_x; }
+	// Row of the last reference suffix processed
+	const SequenceLength* getLastRow() const { return row(h_x_idx - 1); }
+	// Row of the next reference suffix, holding the contribution of the
+	// suffixes that precede it
+	const SequenceLength* getPendingRow() const { return row(h_x_idx); }
+	// i-th row of the current page
+	const SequenceLength* getRow(const SequenceLength i) const { return row(i); }
+	// The pages written to cLCP_x_file are stored by tiles of width colors,
+	// each one holding the rows of the page for its colors
+	void setTileWidth(const SequenceNumber width) { tile_width = width; }
+	// Under memory pressure the pages are given back with the other
+	// scanners of relief (after setTileWidth)
+	void setRelief(PageRelief &relief);
+
+private:
+	const SequenceNumber reference_color;
+	const SequenceNumber m;
+	const SequenceLength n_x;
+	// Rows of a page, halved under memory pressure
+	SequenceLength Q;
+	LCPSource &lcp_x_reader;
+	FILE* cLCP_x_file{nullptr};
+	SparseCLCPWriter* cLCP_x_writer{nullptr};
+	CLCPCheckpointWriter* checkpoint_writer{nullptr};
+	LetterNumber* score_r{nullptr};
+	const bool verbose{false};
+	const bool keep_rows{true};
+	const bool lazy_rows{false};
+	SequenceNumber tile_width{0};
+	PageArena tiles;
+	PageRelief* relief{nullptr};
+	size_t relief_slot{0};
+
+	PageArena cLCP_x;
+	// Full page drained by the writer thread, which then zeroes it, while
+	// the scan fills cLCP_x
+	PageArena written_page;
+	std::thread writer;
+	// Failed write of the writer thread, raised by waitWriter
+	bool write_failed{false};
+	// Colors touched after the h-th reference suffix are stamped h+1
+	std::vector<SequenceLength> touched_stamps;
+	std::vector<SequenceNumber> touched;
+	// Lazy rows: last value of each color, reference suffix it was set at,
+	// and value in the row of the next reference suffix
+	std::vector<SequenceLength> last_values;
+	std::vector<SequenceLength> last_refs;
+	std::vector<SequenceLength> pending_values;
+	// Increasing minima of the lcp_x values since the last checkpoint:
+	// reference suffix and value
+	std::vector<std::pair<SequenceLength, SequenceLength>> lcp_x_minima;
+	SequenceLength h_x{0};
+	SequenceLength h_x_idx{0};
+	SequenceLength alpha{C_MaxSequenceLength};
+	SequenceLength k{0};
+	SequenceLength lcp_x_value{0};
+	// Suffixes processed since begin()
+	LetterNumber position{0};
+
+	SequenceLength* row(const SequenceLength i) { return cLCP_x.row(i); }
+	const SequenceLength* row(const SequenceLength i) const { return cLCP_x.row(i); }
+	ForwardScanner(const SequenceNumber reference_color,
+			const SequenceNumber m,
+			const SequenceLength n_x,
+			const SequenceLength Q,
+			LCPSource &lcp_x_reader,
+			FILE* cLCP_x_file,
+			SparseCLCPWriter* cLCP_x_writer,
+			CLCPCheckpointWriter* checkpoint_writer,
+			LetterNumber score_r[],
+			const bool verbose);
+
+	void touchColor(const SequenceNumber id);
+	void referenceSuffix();
+	void nextReferenceSuffix();
+	void flushPage();
+	bool halvable() const;
+	void followRelief();
+	bool writeRows(const PageArena &page, const SequenceLength rows);
+	void writePage();
+	void waitWriter();
+	void resetTouched();
+	SequenceLength lazyValue(const SequenceNumber r) const;
+	void mergeTouched();
+	void materializeRow();
+};
+
+// Called for every suffix by the scan loops, which inline it: the first
+// suffix of a color and the reference suffixes are handled out of line
+template<class Trace>
+inline void ForwardScanner::processSuffix(const SequenceNumber id,
+		const SequenceLength lcp_value,
+		const SequenceLength d_value,
+		Trace &trace) {
+
+	++position;
+	if(id != reference_color) {
+
+		if(lcp_value < alpha)
+			alpha = lcp_value;
+
+		if((d_value > 0) && (d_value - 1 > k))
+			k = d_value - 1;
+
+		// Value of the suffix, and of color id in the row of the next
+		// reference suffix
+		SequenceLength value = k, row_value = k;
+		if(h_x > 0 && alpha > lcp_x_value) {
+			value = alpha;
+			row_value = lcp_x_value;
+		}
+		else if(h_x > 0) {
+			value = std::max(std::max(alpha,k),lcp_x_value);
+			row_value = std::max(k, lcp_x_value);
+		}
+		if(score_r) score_r[id] += value;
+		if(!keep_rows)
+			return;
+
+		if(h_x == 0 || alpha <= lcp_x_value || h_x < n_x)
+			(lazy_rows ? pending_values.data() : row(h_x_idx))[id] = row_value;
+		trace.suffixValue(id, value);
+
+		if(touched_stamps[id] != h_x + 1)
+			touchColor(id);
+	}
+	else {
+		if(Trace::enabled && h_x > 0 && keep_rows && !lazy_rows)
+			trace.forwardRow(h_x - 1, row(h_x_idx - 1), m);
+		referenceSuffix();
+	}
+}
+
+template<class Trace>
+void ForwardScanner::flushRows(Trace &trace) {
+
+	if(!keep_rows)
+		return;
+
+	if(Trace::enabled && h_x > 0)
+		trace.forwardRow(h_x - 1, row(h_x_idx - 1), m);
+
+	flushPage();
+}
+
+} /* namespace multi_acs */
+
+#endif /* FORWARDSCANNER_H_ */
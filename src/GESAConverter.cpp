@@ -41,6 +41,10 @@
 #include "GESAConverter.h"
 #include "Types.h"
 #include "Tools.h"
+#include "Reader.h"
+#include "Writer.h"
+#include "MemoryGovernor.h"
+#include <memory>
 
 namespace multi_acs {
 
@@ -54,75 +58,80 @@ GESAConverter::~GESAConverter() {
 }
 
 void GESAConverter::extractFromGESA(const std::string &file_path) {
+	std::vector<StackedDGenerator*> no_generators;
+	preprocessGESA(file_path, nullptr, true, no_generators);
+}
 
-		std::string input_file_name = file_path + C_GESAExt;
-		FILE* f_ESA;
-		f_ESA = fopen(input_file_name.c_str(), "rb");
-		if(f_ESA == nullptr) {
-			std::ostringstream err_message;
-			err_message << "Couldn't open file " << input_file_name;
-			Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
-		}
-		// std::cout << "Read EGSA File: " << input_file_name << std::endl;
-
-
-		std::string output_file_name = file_path;
-		FileName ebwt_file_name(output_file_name, C_BwtFileExt);
-		FILE* ebwt_file = fopen(ebwt_file_name.c_str(), "wb");
-		if(ebwt_file == nullptr) {
-			std::ostringstream err_message;
-			err_message << "Couldn't open file " << ebwt_file_name.str();
-			Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
-		}
-		// std::cout << "Write EBWT File: " << ebwt_file_name.str() << std::endl;
-
-		FileName lcp_file_name(output_file_name, C_LcpFileExt);
-		FILE* lcp_file = fopen(lcp_file_name.c_str(), "wb");
-		if(lcp_file == nullptr) {
-			std::ostringstream err_message;
-			err_message << "Couldn't open file " << lcp_file_name.str();
-			Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
-		}
-		// std::cout << "Write LCP File: " << lcp_file_name.str() << std::endl;
-
-		FileName id_file_name(output_file_name, C_IdFileExt);
-		FILE* id_file = fopen(id_file_name.c_str(), "wb");
-		if(id_file == nullptr) {
-			std::ostringstream err_message;
-			err_message << "Couldn't open file " << id_file_name.str();
-			Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
+void GESAConverter::preprocessGESA(const std::string &file_path,
+		CollectionInfo* collection,
+		const bool extract_columns,
+		std::vector<StackedDGenerator*> &d_generators) {
+
+	std::string input_file_name = file_path + C_GESAExt;
+	FILE* f_ESA = fopen(input_file_name.c_str(), "rb");
+	if(f_ESA == nullptr) {
+		std::ostringstream err_message;
+		err_message << "Couldn't open file " << input_file_name;
+		Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
+	}
+	GESAReader gesa_reader(f_ESA);
+
+	std::vector<FILE*> column_files;
+	std::unique_ptr<EBWTWriter> ebwt_writer;
+	std::unique_ptr<LCPWriter> lcp_writer;
+	std::unique_ptr<IdWriter> id_writer;
+	if(extract_columns) {
+		for(const std::string &ext : {C_BwtFileExt, C_LcpFileExt, C_IdFileExt}) {
+			FileName column_file_name(file_path, ext);
+			FILE* column_file = fopen(column_file_name.c_str(), "wb");
+			if(column_file == nullptr) {
+				std::ostringstream err_message;
+				err_message << "Couldn't open file " << column_file_name.str();
+				Error::stopWithError(C_GESAConverter_ClassName, __func__, err_message.str());
+			}
+			column_files.push_back(column_file);
 		}
-		// std::cout << "Write Id File: " << id_file_name.str() << std::endl;
-
-		t_GSA GSA;
-		AlphabetSymbol c;
-		SequenceNumber id;
-		SequenceLength lcp;
-		int num_read;
-		while ((num_read = fread(&GSA, sizeof(t_GSA), 1, f_ESA)) > 0 )  {
-			// cout << GSA.text << "\t" << GSA.suff << "\t" << GSA.lcp << "\t" << GSA.bwt << "\n";
-
-			if (GSA.bwt == '\0')
-				c = TERMINATE_CHAR;
-			else
-				c = GSA.bwt;
-			fwrite(&c, sizeof(AlphabetSymbol), 1, ebwt_file);
-
-			lcp = GSA.lcp;
-			fwrite(&lcp, sizeof(SequenceLength), 1, lcp_file);
-
-			id = GSA.text;
-			fwrite(&id, sizeof(SequenceNumber), 1, id_file);
+		ebwt_writer.reset(new EBWTWriter(column_files[0]));
+		lcp_writer.reset(new LCPWriter(column_files[1]));
+		id_writer.reset(new IdWriter(column_files[2]));
+	}
 
+	for(StackedDGenerator* d_generator : d_generators)
+		d_generator->beginD();
+
+	const t_GSA* block;
+	LetterNumber block_length;
+	while((block_length = gesa_reader.nextSpan(block, BUFFER_SIZE)) > 0) {
+		for(LetterNumber i = 0; i < block_length; ++i) {
+			const t_GSA &GSA = block[i];
+			if(collection != nullptr)
+				collection->collectGESAStruct(GSA);
+			if(extract_columns) {
+				ebwt_writer->writeSymbol(GSA.bwt == '\0' ? TERMINATE_CHAR : GSA.bwt);
+				lcp_writer->writeLCPValue(GSA.lcp);
+				id_writer->writeSequenceId(GSA.text);
+			}
 		}
+		// Each generator goes through the whole block while it is cached
+		for(StackedDGenerator* d_generator : d_generators)
+			for(LetterNumber i = 0; i < block_length; ++i)
+				d_generator->processGESAStruct(block[i]);
+		MemoryGovernor::checkCeiling(C_GESAConverter_ClassName, __func__);
+	}
 
-		fclose(f_ESA);
-		fclose(ebwt_file);
-		fclose(lcp_file);
-		fclose(id_file);
+	for(StackedDGenerator* d_generator : d_generators)
+		d_generator->endD();
 
+	if(extract_columns) {
+		ebwt_writer->flushSymbols();
+		lcp_writer->flushLCPValues();
+		id_writer->flushIds();
+		for(FILE* column_file : column_files)
+			fclose(column_file);
 		std::cout << "Extraction of BWT/LCP/ID from " << input_file_name << " SUCCEEDED" << std::endl;
 	}
+	fclose(f_ESA);
+}
 
 } /* namespace multi_acs */
 
@@ -41,7 +41,10 @@
 #ifndef GESACONVERTER_H_
 #define GESACONVERTER_H_
 
+#include "CollectionInfo.h"
+#include "StackedDGenerator.h"
 #include <string>
+#include <vector>
 
 namespace multi_acs {
 
@@ -53,6 +56,13 @@ public:
 	~GESAConverter();
 
 	static void extractFromGESA(const std::string &file_path);
+	// One scan of the GESA of a collection: collects the symbols and
+	// colors of collection (if given), extracts the BWT/LCP/ID columns
+	// (if extract_columns) and feeds the D generators
+	static void preprocessGESA(const std::string &file_path,
+			CollectionInfo* collection,
+			const bool extract_columns,
+			std::vector<StackedDGenerator*> &d_generators);
 };
 
 } /* namespace multi_acs */
@@ -0,0 +1,92 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "MemoryGovernor.h"
+#include "PageArena.h"
+#include "Tools.h"
+#include "malloc_count/malloc_count.h"
+#include <sstream>
+
+using namespace std;
+
+namespace multi_acs {
+
+AllocableMemory MemoryGovernor::ceiling{0};
+atomic<LetterNumber> MemoryGovernor::heap_bytes{0};
+atomic<LetterNumber> MemoryGovernor::heap_peak{0};
+atomic<LetterNumber> MemoryGovernor::reliefs{0};
+
+void MemoryGovernor::arm(const AllocableMemory ceiling) {
+	heap_bytes = malloc_count_current();
+	heap_peak = heap_bytes.load();
+	MemoryGovernor::ceiling = ceiling;
+	malloc_count_set_callback(&MemoryGovernor::countHeap, nullptr);
+}
+
+void MemoryGovernor::countHeap(void* cookie, size_t current) {
+	heap_bytes.store(current, memory_order_relaxed);
+	// Short-lived buffers between two checks are caught by the peak
+	LetterNumber peak = heap_peak.load(memory_order_relaxed);
+	while(current > peak && !heap_peak.compare_exchange_weak(peak, current, memory_order_relaxed));
+}
+
+LetterNumber MemoryGovernor::currentBytes() {
+	return heap_bytes.load(memory_order_relaxed) + PageArena::currentBytes();
+}
+
+void MemoryGovernor::relieved() {
+	++reliefs;
+	heap_peak.store(heap_bytes.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+void MemoryGovernor::checkCeiling(const char* class_name, const char* caller) {
+	if(ceiling == 0)
+		return;
+	const LetterNumber reached = heap_peak.exchange(heap_bytes.load(memory_order_relaxed), memory_order_relaxed)
+			+ PageArena::currentBytes();
+	if(reached <= ceiling)
+		return;
+	ostringstream err_message;
+	err_message << "Memory of " << reached << " bytes above the ceiling of " << ceiling
+			<< " bytes, with nothing left to give back";
+	Error::stopWithError(class_name, caller, err_message.str());
+}
+
+} /* namespace multi_acs */
@@ -0,0 +1,87 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#ifndef MEMORYGOVERNOR_H_
+#define MEMORYGOVERNOR_H_
+
+#include "Types.h"
+#include <atomic>
+#include <cstddef>
+
+namespace multi_acs {
+
+const char C_MemoryGovernor_ClassName[]{"MemoryGovernor"};
+
+// Ceiling on the heap (followed by the malloc_count callback) and the page
+// arenas of a run, not on its resident set. Above 7/8 of it the memory is
+// under pressure: the cLCP passes give back pages at their page boundaries
+// (relieved). The ceiling is checked at those boundaries and at the blocks
+// of the other scans, against the highest heap since the previous check,
+// and the run stops with an error above it.
+class MemoryGovernor {
+public:
+	static void arm(const AllocableMemory ceiling);
+	static bool armed() { return ceiling > 0; }
+	static AllocableMemory getCeiling() { return ceiling; }
+	static LetterNumber currentBytes();
+	static bool underPressure() {
+		return ceiling > 0 && currentBytes() >= ceiling - ceiling/8;
+	}
+	// A pass gave back memory under pressure: the peak reached before is
+	// not held against the run
+	static void relieved();
+	static LetterNumber getReliefs() { return reliefs; }
+	// Stops the run from caller of class_name when the ceiling was crossed
+	// since the previous check
+	static void checkCeiling(const char* class_name, const char* caller);
+
+private:
+	static AllocableMemory ceiling;
+	static std::atomic<LetterNumber> heap_bytes;
+	static std::atomic<LetterNumber> heap_peak;
+	static std::atomic<LetterNumber> reliefs;
+
+	// Callback of malloc_count, which must not allocate
+	static void countHeap(void* cookie, size_t current);
+};
+
+} /* namespace multi_acs */
+
+#endif /* MEMORYGOVERNOR_H_ */
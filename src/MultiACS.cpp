@@ -46,13 +46,27 @@
 #include "Reader.h"
 #include "StackedDGenerator.h"
 #include "GESAConverter.h"
+#include "ForwardScanner.h"
+#include "RowKernels.h"
+#include "PageArena.h"
+#include "Planner.h"
+#include "MemoryGovernor.h"
+#include "StripeWorkers.h"
 #include "malloc_count/malloc_count.h"
 #include <vector>
+#include <memory>
+#include <thread>
 #include <unistd.h>
+#include <getopt.h>
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <climits>
 #include <cmath>
+#include <cstddef>
+#include <algorithm>
 
 
 
@@ -63,7 +77,10 @@ namespace multi_acs {
 MultiACS::MultiACS(MultiACSParameters* params) :
 	params(params),
 	global_collection(params->target_collection_file_name, true, params->file_format, params->verbose),
-	reference_color(params->reference_color) {
+	reference_color(params->reference_color),
+	reference_colors(params->reference_colors),
+	id_column(idColumn(params->target_collection_file_name)),
+	lcp_column(lcpColumn(params->target_collection_file_name)) {
 
 	if(global_collection.colors.count(params->reference_color) == 0) {
 		ostringstream err_message;
@@ -71,8 +88,9 @@ MultiACS::MultiACS(MultiACSParameters* params) :
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 	global_collection.printCollectionInfo();
+	setReference(0);
 
-	generateD();
+	generateD(vector<SequenceNumber>(1, reference_color));
 	generateLCP();
 
 }
@@ -80,30 +98,77 @@ MultiACS::MultiACS(MultiACSParameters* params) :
 MultiACS::MultiACS(MultiACSParameters* params, CollectionInfo &collection) :
 	params(params),
 	global_collection(collection),
-	reference_color(params->reference_color) { }
+	reference_color(params->reference_color),
+	reference_colors(params->reference_colors),
+	id_column(idColumn(params->target_collection_file_name)),
+	lcp_column(lcpColumn(params->target_collection_file_name)) {
+
+	if(params->all_vs_all) {
+		reference_colors.clear();
+		for(auto it = global_collection.colors.begin(); it != global_collection.colors.end(); ++it)
+			reference_colors.push_back(it->first);
+	}
+	setReference(0);
+}
 
 MultiACS::~MultiACS() {
 	// TODO Auto-generated destructor stub
 }
 
-void MultiACS::generateD() {
-	StackedDGenerator d_gen(params);
-	d_gen.generateD();
+// D files of the reference colors, by one scan of the target collection
+void MultiACS::generateD(const vector<SequenceNumber> &colors) {
+	StackedDGenerator::generateD(params, colors);
 }
 
 void MultiACS::generateLCP() {
 	// TODO NOT YET IMPLEMENTED
 }
 
+// Make the k-th reference the current one
+void MultiACS::setReference(const SequenceNumber k) {
+	reference_color = reference_colors[k];
+	reference_lcp_column = referenceLCPColumn(k);
+}
+
+// Columns of a collection: fields of the records of its .gesa file, or the
+// extracted .id and .lcp files
+ColumnFile MultiACS::idColumn(const std::string &collection_file_name) const {
+	if(params->gesa_columns)
+		return {collection_file_name + C_GESAExt, sizeof(t_GSA), offsetof(t_GSA, text), sizeof(int_text)};
+	return {collection_file_name + C_IdFileExt, sizeof(SequenceNumber), 0, sizeof(SequenceNumber)};
+}
+
+ColumnFile MultiACS::lcpColumn(const std::string &collection_file_name) const {
+	if(params->gesa_columns)
+		return {collection_file_name + C_GESAExt, sizeof(t_GSA), offsetof(t_GSA, lcp), sizeof(int_lcp)};
+	return {collection_file_name + C_LcpFileExt, sizeof(SequenceLength), 0, sizeof(SequenceLength)};
+}
+
+// A derived LCP is copied by the forward computation next to the working
+// files, otherwise it is read from the GESA of the reference
+ColumnFile MultiACS::referenceLCPColumn(const SequenceNumber k) const {
+	if(params->derive_lcp || params->all_vs_all)
+		return {params->workingFileName(reference_colors[k]) + C_ReferenceLcpFileExt, sizeof(SequenceLength), 0, sizeof(SequenceLength)};
+	return lcpColumn(params->reference_sequence_file_names[k]);
+}
+
+FILE* MultiACS::openFile(const FileName &file_name, const char* mode) {
+	FILE* file = fopen(file_name.c_str(), mode);
+	if(file == nullptr) {
+		ostringstream err_message;
+		err_message << "Couldn't open file " << file_name.str();
+		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	}
+	return file;
+}
+
 void MultiACS::computeACS() {
 
-	SequenceNumber m = global_collection.getSequenceNumber();
-	SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceNumber K = reference_colors.size();
 
-	LetterNumber score_x[m]{0};
-	memset (score_x, 0, m);
-	LetterNumber score_r[m]{0};
-	memset (score_r, 0, m);
+	vector<vector<LetterNumber>> score_x(K, vector<LetterNumber>(m, 0));
+	vector<vector<LetterNumber>> score_r(K, vector<LetterNumber>(m, 0));
 
 	clock_t start = clock();
 	time_t start_wc = time(NULL);
@@ -113,7 +178,10 @@ void MultiACS::computeACS() {
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
 
 	forwardComputation(score_r);
-	backwardComputation(score_x);
+	for(SequenceNumber k = 0; k < K; ++k) {
+		setReference(k);
+		backwardComputation(score_x[k].data());
+	}
 
 	//cout << "ACS distance_file_name\n";
 	
@@ -125,8 +193,40 @@ void MultiACS::computeACS() {
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
+	// One line for each reference
+	for(SequenceNumber k = 0; k < K; ++k) {
+		setReference(k);
+		writeDistances(distance_file, score_x[k].data(), score_r[k].data());
+		if(K > 1)
+			fprintf(distance_file, "\n");
+	}
+
+	fclose(distance_file);
+
+	cout << "ACS Computation End\n";
+	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+
+	elapsed = (clock()-start)/(double)(CLOCKS_PER_SEC);
+	elapsed_wc = difftime(time(NULL),start_wc);
+
+	cout << "### ACS Computation Reporting ###\n";
+	cout << "Elapsed time: " << elapsed << " secs\n";
+	cout << "Wall Clock time: " << elapsed_wc << " secs\n";
+	cout << "Peak memory: " << malloc_count_peak() << " bytes\n";
+	cout << "Peak page arena memory: " << PageArena::peakBytes() << " bytes\n";
+	cout << endl;
+
+}
+
+void MultiACS::writeDistances(FILE* distance_file,
+		const LetterNumber score_x[],
+		const LetterNumber score_r[]) {
+
 //	AlphabetSize sigma = global_collection.getAlphabetSize() - 1;
 //	double base = log(sigma);
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+
 	SequenceLength s1, s2;
 	DistanceValue sumS1, sumS2;
 	DistanceValue distance = 0;
@@ -161,202 +261,465 @@ void MultiACS::computeACS() {
 		}
 	}
 
+}
+
+void MultiACS::computeAllVsAll() {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+
+	// score_r[x][r] is the score of r against x
+	vector<vector<LetterNumber>> score_r(m, vector<LetterNumber>(m, 0));
+	vector<LetterNumber> score_x(m, 0);
+
+	clock_t start = clock();
+	time_t start_wc = time(NULL);
+	double elapsed, elapsed_wc;
+
+	cout << "All-vs-all ACS Computation Starting\n";
+	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+
+	forwardComputation(score_r);
+
+	FileName distance_file_name(params->output_file_name, C_DistanceFileExt);
+	FILE* distance_file = fopen(distance_file_name.c_str(), "w");
+	if(distance_file == nullptr) {
+		ostringstream err_message;
+		err_message << "Couldn't open file " << distance_file_name.str();
+		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	}
+
+	for(SequenceNumber x = 0; x < m; ++x) {
+		setReference(x);
+		for(SequenceNumber r = 0; r < m; ++r)
+			score_x[r] = score_r[r][x];
+		writeDistances(distance_file, score_x.data(), score_r[x].data());
+		fprintf(distance_file, "\n");
+	}
+
 	fclose(distance_file);
 
-	cout << "ACS Computation End\n";
+	cout << "All-vs-all ACS Computation End\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
 
 	elapsed = (clock()-start)/(double)(CLOCKS_PER_SEC);
 	elapsed_wc = difftime(time(NULL),start_wc);
 
-	cout << "### ACS Computation Reporting ###\n";
+	cout << "### All-vs-all ACS Computation Reporting ###\n";
 	cout << "Elapsed time: " << elapsed << " secs\n";
 	cout << "Wall Clock time: " << elapsed_wc << " secs\n";
 	cout << "Peak memory: " << malloc_count_peak() << " bytes\n";
+	cout << "Peak page arena memory: " << PageArena::peakBytes() << " bytes\n";
 	cout << endl;
 
 }
 
-void MultiACS::forwardComputation(LetterNumber score_r[]) {
+/* The references are served in blocks, each one by a single scan of the
+ * target collection: one D stream, one page of rows and one score_r for
+ * each reference of the block, the pages sharing the -Q memory.
+ * In all-vs-all mode only score_r is computed and the D of the block is
+ * generated right before its scan.
+ */
+void MultiACS::forwardComputation(vector<vector<LetterNumber>> &score_r) {
 
 	const SequenceNumber m = global_collection.getSequenceNumber();
-	const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
-
-	FileName id_file_name(params->target_collection_file_name, C_IdFileExt);
-	FILE* id_file = fopen(id_file_name.c_str(), "rb");
-	if(id_file == nullptr) {
-		ostringstream err_message;
-		err_message << "Couldn't open file " << id_file_name.str();
-		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	const SequenceNumber K = reference_colors.size();
+	const bool keep_rows = !params->all_vs_all;
+
+	const SequenceNumber B = params->scanReferences(K, m);
+	const SequenceLength Q = params->forwardPageRows(K, m);
+	// The backward computation reads the tiled pages as they were written
+	forward_page_rows = Q;
+	if(params->tiled_clcp) {
+		tile_width = colorTileWidth(Q, m);
+		cout << "Tiles of " << tile_width << " colors\n";
 	}
-//	cout << "Reading from" << id_file_name.str() << endl;
 
-	FileName lcp_file_name(params->target_collection_file_name, C_LcpFileExt);
-	FILE* lcp_file = fopen(lcp_file_name.c_str(), "rb");
-	if(lcp_file == nullptr) {
-		ostringstream err_message;
-		err_message << "Couldn't open file " << lcp_file_name.str();
-		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
-	}
-//	cout << "Reading from" << lcp_file_name.str() << endl;
+	cout << "cLCP Forward Computation\n";
+	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
 
-	FileName d_file_name(params->output_file_name, C_DynBlockFileExt);
-	FILE* d_file = fopen(d_file_name.c_str(), "rb");
-	if(d_file == nullptr) {
-		ostringstream err_message;
-		err_message << "Couldn't open file " << d_file_name.str();
-		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	if(keep_rows && params->chunkedForward()) {
+		const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+		fclose(openFile(FileName(params->workingFileName(reference_color), C_PartialCLcpFileExt), "wb"));
+		if(params->derive_lcp)
+			fclose(openFile(FileName(reference_lcp_column.file_name), "wb"));
+		parallelForwardComputation(score_r[0].data(), Q > n_x ? n_x : Q);
+		return;
 	}
-//	cout << "Reading from" << d_file_name.str() << endl;
 
-	FileName lcp_x_file_name = FileName(params->reference_sequence_file_name, C_LcpFileExt);
-	FILE* lcp_x_file = fopen(lcp_x_file_name.c_str(), "rb");
-	if(lcp_x_file == nullptr) {
-		ostringstream err_message;
-		err_message << "Couldn't open file " << lcp_x_file_name.str();
-		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
-	}
-//	cout << "Reading from" << lcp_x_file_name.str() << endl;
+	for(SequenceNumber first = 0; first < K; first += B) {
 
-	FileName cLCP_x_file_name(params->output_file_name, C_PartialCLcpFileExt);
-	FILE* cLCP_x_file = fopen(cLCP_x_file_name.c_str(), "wb");
-	if(cLCP_x_file == nullptr) {
-		ostringstream err_message;
-		err_message << "Couldn't open file " << cLCP_x_file_name.str();
-		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
-	}
-//	cout << "Writing from" << cLCP_x_file_name.str() << endl;
+		const SequenceNumber last = min<SequenceNumber>(first + B, K);
+		if(params->all_vs_all && !params->inlineD())
+			generateD(vector<SequenceNumber>(reference_colors.begin() + first, reference_colors.begin() + last));
 
-	AllocableMemory A = params->memory_amount/sizeof(SequenceLength);
+		if(K > 1)
+			cout << "Forward scan of references " << first << "-" << last - 1 << endl;
 
-	SequenceLength Q = ceil((double) A/m);
-	Q = Q > n_x ? n_x : Q;
+		// The references of the block are split among the workers, which
+		// give back pages together under memory pressure
+		PageRelief relief(m);
+		unsigned int T = params->verbose ? 1 : params->threads;
+		T = T > (unsigned int) (last - first) ? last - first : T;
+		if(T <= 1) {
+			forwardScan(first, last, Q, score_r, relief);
+		}
+		else {
+			vector<thread> workers;
+			for(unsigned int t = 0; t < T; ++t) {
+				workers.push_back(thread(&MultiACS::forwardScan, this,
+						first + ((last - first)*t)/T, first + ((last - first)*(t + 1))/T,
+						Q, ref(score_r), ref(relief)));
+			}
+			for(thread &worker : workers)
+				worker.join();
+		}
 
-	SequenceLength cLCP_x[Q + 1][m];
-	memset(cLCP_x, 0, sizeof(cLCP_x));
-	bool LcLCPbit_x[m];
+		// D files of all-vs-all mode are not kept
+		if(params->all_vs_all && !params->inlineD())
+			for(SequenceNumber k = first; k < last; ++k)
+				remove(FileName(params->workingFileName(reference_colors[k]), C_DynBlockFileExt).c_str());
+	}
+}
 
-	IdReader id_reader(id_file);
-	LCPReader lcp_reader(lcp_file);
-	LCPReader lcp_x_reader(lcp_x_file);
-	DReader d_reader(d_file);
+// Each block of the collection is processed in place by every scanner
+template<class Trace>
+static void scanTarget(IdReader &id_reader,
+		LCPReader &lcp_reader,
+		InlineDGenerator* inline_d,
+		vector<unique_ptr<DReader>> &d_readers,
+		vector<unique_ptr<ForwardScanner>> &scanners,
+		vector<Trace> &traces,
+		PageRelief &relief) {
+
+	const SequenceNumber* ids;
+	const SequenceLength *lcp_values, *d_values;
+	LetterNumber block_length;
+
+	for(auto &scanner : scanners)
+		scanner->begin();
+	while((block_length = id_reader.nextSpan(ids, BUFFER_SIZE)) > 0) {
+		lcp_reader.nextSpan(lcp_values, block_length);
+		if(inline_d)
+			inline_d->nextSpans(block_length);
+		for(size_t j = 0; j < scanners.size(); ++j) {
+			if(inline_d)
+				d_values = inline_d->getSpan(j);
+			else
+				d_readers[j]->nextSpan(d_values, block_length);
+			for(LetterNumber i = 0; i < block_length; ++i)
+				scanners[j]->processSuffix(ids[i], lcp_values[i], d_values[i], traces[j]);
+		}
+		relief.checkCeiling(C_MultiACS_ClassName, __func__);
+	}
+	for(size_t j = 0; j < scanners.size(); ++j)
+		scanners[j]->flushRows(traces[j]);
+}
 
-	SequenceLength h_x = 0;
-	SequenceLength h_x_idx = 0;
-	SequenceLength alpha = C_MaxSequenceLength;
-	SequenceLength k = 0;
-	SequenceNumber id;
-	SequenceLength lcp_x_value;
+// Forward computation of the references first..last-1 by one scan of the
+// target collection. With Q = 0 only score_r is computed.
+// A derived LCP of a reference is copied for the backward computation.
+void MultiACS::forwardScan(const SequenceNumber first,
+		const SequenceNumber last,
+		const SequenceLength Q,
+		vector<vector<LetterNumber>> &score_r,
+		PageRelief &relief) {
 
-	cout << "cLCP Forward Computation\n";
-	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+	const SequenceNumber m = global_collection.getSequenceNumber();
 
-	lcp_x_reader.readLCPValue(lcp_x_value);
-	while(id_reader.readSequenceId(id)) {
+	FILE* id_file = openFile(FileName(id_column.file_name), "rb");
+	FILE* lcp_file = openFile(FileName(lcp_column.file_name), "rb");
+	vector<FILE*> files;
+
+	vector<unique_ptr<DReader>> d_readers;
+	vector<unique_ptr<LCPSource>> lcp_x_readers;
+	vector<DerivedLCPReader*> derived_readers;
+	vector<unique_ptr<SparseCLCPWriter>> cLCP_x_writers;
+	vector<unique_ptr<CLCPCheckpointWriter>> checkpoint_writers;
+	vector<unique_ptr<ForwardScanner>> scanners;
+	for(SequenceNumber k = first; k < last; ++k) {
+
+		const SequenceNumber color = reference_colors[k];
+		const SequenceLength n_x = global_collection.getSequenceLength(color);
+		const string working_file_name = params->workingFileName(color);
+
+		if(!params->inlineD()) {
+			files.push_back(openFile(FileName(working_file_name, C_DynBlockFileExt), "rb"));
+			d_readers.push_back(unique_ptr<DReader>(new DReader(files.back())));
+		}
 
-		SequenceLength lcp_value, d_value;
-		lcp_reader.readLCPValue(lcp_value);
-		d_reader.readDValue(d_value);
+		if(params->derive_lcp || params->all_vs_all) {
+			FILE* id_x_file = openFile(FileName(id_column.file_name), "rb");
+			FILE* lcp_x_file = openFile(FileName(lcp_column.file_name), "rb");
+			FILE* copy_file = (Q > 0) ? openFile(FileName(referenceLCPColumn(k).file_name), "wb") : nullptr;
+			files.push_back(id_x_file);
+			files.push_back(lcp_x_file);
+			if(copy_file != nullptr)
+				files.push_back(copy_file);
+			derived_readers.push_back(new DerivedLCPReader(id_x_file, lcp_x_file,
+					id_column, lcp_column, 0, color, copy_file));
+			lcp_x_readers.push_back(unique_ptr<LCPSource>(derived_readers.back()));
+		}
+		else {
+			const ColumnFile lcp_x_column = referenceLCPColumn(k);
+			files.push_back(openFile(FileName(lcp_x_column.file_name), "rb"));
+			lcp_x_readers.push_back(unique_ptr<LCPSource>(new LCPReader(files.back(), lcp_x_column)));
+		}
 
-		if(id != reference_color) {
+		FILE* cLCP_x_file = nullptr;
+		if(Q > 0 && !params->checkpoint_clcp) {
+			cLCP_x_file = openFile(FileName(working_file_name, C_PartialCLcpFileExt), "wb");
+			files.push_back(cLCP_x_file);
+		}
 
-			if(lcp_value < alpha)
-				alpha = lcp_value;
+		if(Q > 0 && params->checkpoint_clcp) {
+			files.push_back(openFile(FileName(working_file_name, C_CLcpCheckpointFileExt), "wb"));
+			checkpoint_writers.push_back(unique_ptr<CLCPCheckpointWriter>(
+					new CLCPCheckpointWriter(files.back(), m, Q > n_x ? n_x : Q)));
+			scanners.push_back(unique_ptr<ForwardScanner>(new ForwardScanner(color,
+					m, n_x, Q > n_x ? n_x : Q,
+					*lcp_x_readers.back(), *checkpoint_writers.back(), score_r[k].data(), params->verbose)));
+		}
+		else if(Q > 0 && params->sparse_clcp) {
+			files.push_back(openFile(FileName(working_file_name, C_PartialCLcpIndexFileExt), "wb"));
+			cLCP_x_writers.push_back(unique_ptr<SparseCLCPWriter>(
+					new SparseCLCPWriter(cLCP_x_file, files.back(), m)));
+			scanners.push_back(unique_ptr<ForwardScanner>(new ForwardScanner(color,
+					m, n_x, Q > n_x ? n_x : Q,
+					*lcp_x_readers.back(), *cLCP_x_writers.back(), score_r[k].data(), params->verbose)));
+		}
+		else {
+			scanners.push_back(unique_ptr<ForwardScanner>(new ForwardScanner(color,
+					m, n_x, Q > n_x ? n_x : Q,
+					*lcp_x_readers.back(), cLCP_x_file, score_r[k].data(), params->verbose)));
+			if(params->tiled_clcp)
+				scanners.back()->setTileWidth(tile_width);
+		}
+		scanners.back()->setRelief(relief);
+	}
 
-			if((d_value > 0) && (d_value - 1 > k))
-				k = d_value - 1;
+	// D of every reference of the scan, computed inline by one more scan
+	unique_ptr<InlineDGenerator> inline_d;
+	if(params->inlineD()) {
+		FILE* id_d_file = openFile(FileName(id_column.file_name), "rb");
+		FILE* lcp_d_file = openFile(FileName(lcp_column.file_name), "rb");
+		files.push_back(id_d_file);
+		files.push_back(lcp_d_file);
+		inline_d.reset(new InlineDGenerator(params,
+				vector<SequenceNumber>(reference_colors.begin() + first, reference_colors.begin() + last),
+				id_d_file, id_column, lcp_d_file, lcp_column));
+	}
 
-			if(h_x == 0) {
-				score_r[id] += k;
-				cLCP_x[h_x_idx][id] = k;
-				if(params->verbose) {
-					cout << id << ": " << k << endl;
-				}
-//				cout << id << ": " << k << endl;
-			}
-			else if(alpha > lcp_x_value) {
-				score_r[id] += alpha;
-				if(h_x < n_x) {
-					cLCP_x[h_x_idx][id] = lcp_x_value;
-				}
-				if(params->verbose) {
-					cout << id << ": " << alpha << endl;
-				}
-//				cout << id << ": " << alpha << endl;
-			}
-			else {
-				score_r[id] += max(max(alpha,k),lcp_x_value);
-				cLCP_x[h_x_idx][id] = max(k, lcp_x_value);
-				if(params->verbose) {
-					cout << id << ": " << max(max(alpha,k),lcp_x_value) << endl;
-				}
-//				cout << id << ": " << max(max(alpha,k),lcp_x_value) << endl;
-			}
+	IdReader id_reader(id_file, id_column);
+	LCPReader lcp_reader(lcp_file, lcp_column);
 
-			if(h_x > 0 && LcLCPbit_x[id] == false) {
-				if(alpha > cLCP_x[h_x_idx - 1][id])
-					cLCP_x[h_x_idx - 1][id] = alpha;
-				LcLCPbit_x[id] = true;
-			}
+	// With -v the values and rows of each reference are traced to a file
+	if(params->verbose) {
+		vector<TraceWriter> traces;
+		for(SequenceNumber k = first; k < last; ++k) {
+			files.push_back(openFile(FileName(params->workingFileName(reference_colors[k]), C_TraceFileExt), "wb"));
+			traces.push_back(TraceWriter(files.back()));
 		}
-		else {
-			if(h_x > 0) {
-				for(SequenceNumber r = 0; r < m; ++r) {
-					cLCP_x[h_x_idx][r] = max(min(cLCP_x[h_x_idx - 1][r], lcp_x_value), cLCP_x[h_x_idx][r]);
-				}
+		scanTarget(id_reader, lcp_reader, inline_d.get(), d_readers, scanners, traces, relief);
+	}
+	else {
+		vector<NoTrace> traces(scanners.size());
+		scanTarget(id_reader, lcp_reader, inline_d.get(), d_readers, scanners, traces, relief);
+	}
+	for(DerivedLCPReader* lcp_x_reader : derived_readers)
+		lcp_x_reader->flushCopy();
 
-				if(params->verbose) {
-					cout << "[" << h_x - 1 << "]:";
-					for(SequenceNumber r = 0; r < m; ++r) {
-						cout << " " << cLCP_x[h_x_idx - 1][r];
-					}
-					cout << endl;
-				}
-//				cout << "[" << h_x - 1 << "]:";
-//				for(SequenceNumber r = 0; r < m; ++r) {
-//					cout << " " << cLCP_x[h_x_idx - 1][r];
-//				}
-//				cout << endl;
-			}
+	for(FILE* file : files)
+		fclose(file);
+	fclose(lcp_file);
+	fclose(id_file);
+}
 
-			++h_x;
-			++h_x_idx;
-			if(h_x_idx == Q + 1) {
-				fwrite(cLCP_x[0], sizeof(SequenceLength), Q*m, cLCP_x_file);
-				for(SequenceNumber r = 0; r < m; ++r) {
-					cLCP_x[0][r] = cLCP_x[Q][r];
-					for(SequenceLength j = 1; j < Q + 1; ++j){
-						cLCP_x[j][r] = 0;
-					}
-				}
-				h_x_idx = 1;
-			}
-			alpha = C_MaxSequenceLength;
-			k = 0;
-			for(SequenceNumber r = 0; r < m; ++r) {
-				LcLCPbit_x[r] = false;
-			}
+/* The forward computation is split in chunks starting at a reference suffix.
+ * The only information crossing a chunk boundary is the row propagation
+ * row[h] = max(min(row[h-1], lcp_x[h]), B[h]), which composes as
+ * row[h+j] = max(local[h+j], min(row[h-1], lcp_x[h], ..., lcp_x[h+j])).
+ * Each chunk is processed from a zero row, then the rows crossing the
+ * boundaries are computed by a scan over the chunks and each chunk is fixed.
+ */
+void MultiACS::parallelForwardComputation(LetterNumber score_r[], const SequenceLength Q) {
 
-			if(!lcp_x_reader.readLCPValue(lcp_x_value))
-				lcp_x_value = 0;
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const LetterNumber n = global_collection.size;
+	// Each worker gets at least one reference suffix and one row of the
+	// page memory, which is shared among the workers (Q is at most n_x)
+	const unsigned int T = min<LetterNumber>(params->threads, max<LetterNumber>(Q, 1));
+	const SequenceLength Q_t = Q/T > 0 ? Q/T : 1;
+
+	// Reference suffixes in T equal ranges of the collection
+	vector<SequenceLength> range_refs(T, 0);
+	vector<LetterNumber> range_first(T, C_MaxLetterNumber);
+	vector<thread> workers;
+	for(unsigned int t = 0; t < T; ++t) {
+		workers.push_back(thread(&MultiACS::countReferenceSuffixes, this,
+				(n*t)/T, (n*(t + 1))/T, ref(range_refs[t]), ref(range_first[t])));
+	}
+	for(thread &worker : workers)
+		worker.join();
+	workers.clear();
+
+	vector<ForwardChunk> chunks(1);
+	chunks[0].start = 0;
+	chunks[0].h = 0;
+	SequenceLength refs_before = range_refs[0];
+	for(unsigned int t = 1; t < T; ++t) {
+		if(range_refs[t] > 0) {
+			chunks.push_back(ForwardChunk());
+			chunks.back().start = range_first[t];
+			chunks.back().h = refs_before;
+			refs_before += range_refs[t];
 		}
 	}
+	for(size_t c = 0; c < chunks.size(); ++c)
+		chunks[c].end = (c + 1 < chunks.size()) ? chunks[c + 1].start : n;
+
+	PageRelief relief(m);
+	for(ForwardChunk &chunk : chunks)
+		workers.push_back(thread(&MultiACS::forwardChunk, this, ref(chunk), Q_t, ref(relief)));
+	for(thread &worker : workers)
+		worker.join();
+	workers.clear();
+
+	// A derived lcp_x[h] is written by the chunk preceding h
+	FILE* lcp_x_file = openFile(FileName(reference_lcp_column.file_name), "rb");
+	{
+		LCPReader lcp_x_reader(lcp_x_file, reference_lcp_column);
+		for(size_t c = 1; c < chunks.size(); ++c)
+			chunks[c].first_lcp_x = (chunks[c].h < lcp_x_reader.getLength()) ? lcp_x_reader.at(chunks[c].h) : 0;
+	}
+	fclose(lcp_x_file);
+
+	// Rows crossing the chunk boundaries
+	vector<SequenceLength> carry(chunks[0].last_row);
+	for(size_t c = 1; c < chunks.size(); ++c) {
+		ForwardChunk &chunk = chunks[c];
+		const vector<SequenceLength> &pending = chunks[c - 1].pending_row;
+		chunk.carry.assign(m, 0);
+		maxMinRow(chunk.carry.data(), carry.data(), chunk.first_lcp_x, pending.data(), m);
+		maxMinRow(carry.data(), chunk.carry.data(), chunk.min_lcp_x, chunk.last_row.data(), m);
+	}
 
-	if(params->verbose) {
-		cout << "[" << h_x - 1 << "]:";
-		for(SequenceNumber r = 0; r < m; ++r) {
-			cout << " " << cLCP_x[h_x_idx - 1][r];
+	for(size_t c = 1; c < chunks.size(); ++c)
+		workers.push_back(thread(&MultiACS::fixForwardChunk, this, ref(chunks[c]), Q_t));
+	for(thread &worker : workers)
+		worker.join();
+
+	for(ForwardChunk &chunk : chunks)
+		addScores(score_r, chunk.score_r.data(), m);
+}
+
+void MultiACS::countReferenceSuffixes(const LetterNumber start,
+		const LetterNumber end,
+		SequenceLength &refs,
+		LetterNumber &first_pos) {
+
+	FILE* id_file = openFile(FileName(id_column.file_name), "rb");
+	IdReader id_reader(id_file, id_column, start);
+
+	SequenceNumber id;
+	refs = 0;
+	first_pos = C_MaxLetterNumber;
+	for(LetterNumber i = start; i < end && id_reader.readSequenceId(id); ++i) {
+		if(id == reference_color) {
+			if(refs == 0)
+				first_pos = i;
+			++refs;
 		}
-		cout << endl;
 	}
-//	cout << "[" << h_x - 1 << "]:";
-//	for(SequenceNumber r = 0; r < m; ++r) {
-//		cout << " " << cLCP_x[h_x_idx - 1][r];
-//	}
-//	cout << endl;
 
-	fwrite(cLCP_x[0], sizeof(SequenceLength), h_x_idx*m, cLCP_x_file);
+	fclose(id_file);
+}
+
+void MultiACS::forwardChunk(ForwardChunk &chunk, const SequenceLength Q, PageRelief &relief) {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+	// Every chunk but the first starts with a reference suffix
+	const bool first_chunk = (chunk.start == 0);
+	const LetterNumber start = first_chunk ? 0 : chunk.start + 1;
+	const SequenceLength lcp_x_start = first_chunk ? 0 : chunk.h + 1;
+
+	FILE* id_file = openFile(FileName(id_column.file_name), "rb");
+	FILE* lcp_file = openFile(FileName(lcp_column.file_name), "rb");
+	FILE* d_file = openFile(FileName(params->workingFileName(reference_color), C_DynBlockFileExt), "rb");
+	FILE* lcp_x_file = openFile(FileName(reference_lcp_column.file_name), params->derive_lcp ? "r+b" : "rb");
+	FILE* cLCP_x_file = openFile(FileName(params->workingFileName(reference_color), C_PartialCLcpFileExt), "r+b");
+	fseeko(cLCP_x_file, (off_t) chunk.h*m*sizeof(SequenceLength), SEEK_SET);
+
+	// A derived lcp_x is computed from a second scan of the chunk, and its
+	// values are written in place
+	FILE* id_x_file = nullptr;
+	FILE* lcp_x_src_file = nullptr;
+	DerivedLCPReader* derived_reader = nullptr;
+	unique_ptr<LCPSource> lcp_x_reader;
+	if(params->derive_lcp) {
+		id_x_file = openFile(FileName(id_column.file_name), "rb");
+		lcp_x_src_file = openFile(FileName(lcp_column.file_name), "rb");
+		fseeko(lcp_x_file, (off_t) lcp_x_start*sizeof(SequenceLength), SEEK_SET);
+		derived_reader = new DerivedLCPReader(id_x_file, lcp_x_src_file,
+				id_column, lcp_column, start, reference_color, lcp_x_file);
+		lcp_x_reader.reset(derived_reader);
+	}
+	else {
+		lcp_x_reader.reset(new LCPReader(lcp_x_file, reference_lcp_column, lcp_x_start));
+	}
+
+	IdReader id_reader(id_file, id_column, start);
+	LCPReader lcp_reader(lcp_file, lcp_column, start);
+	DReader d_reader(d_file, start);
+
+	chunk.score_r.assign(m, 0);
+	ForwardScanner scanner(reference_color, m, n_x, Q,
+			*lcp_x_reader, cLCP_x_file, chunk.score_r.data());
+	scanner.setRelief(relief);
+	const SequenceNumber* ids;
+	const SequenceLength *lcp_values, *d_values;
+	LetterNumber block_length;
+
+	if(first_chunk)
+		scanner.begin();
+	else
+		scanner.resume(chunk.h, nullptr);
+	for(LetterNumber i = start; i < chunk.end; i += block_length) {
+		block_length = id_reader.nextSpan(ids, min((LetterNumber) BUFFER_SIZE, chunk.end - i));
+		if(block_length == 0)
+			break;
+		lcp_reader.nextSpan(lcp_values, block_length);
+		d_reader.nextSpan(d_values, block_length);
+		for(LetterNumber j = 0; j < block_length; ++j)
+			scanner.processSuffix(ids[j], lcp_values[j], d_values[j]);
+		relief.checkCeiling(C_MultiACS_ClassName, __func__);
+	}
+	scanner.flushRows();
+
+	chunk.refs = scanner.getReferenceSuffixes() - chunk.h;
+	if(chunk.refs > 0)
+		chunk.last_row.assign(scanner.getLastRow(), scanner.getLastRow() + m);
+	else
+		chunk.last_row.assign(m, 0);
+	chunk.pending_row.assign(scanner.getPendingRow(), scanner.getPendingRow() + m);
+
+	// The derived values are read back through a mapping of the file
+	if(derived_reader != nullptr) {
+		derived_reader->flushCopy();
+		fflush(lcp_x_file);
+	}
+
+	// lcp_x values of the reference suffixes of the chunk following the first
+	LCPReader chunk_lcp_x_reader(lcp_x_file, reference_lcp_column, chunk.h + 1);
+	SequenceLength lcp_x_value;
+	chunk.min_lcp_x = C_MaxSequenceLength;
+	for(SequenceLength j = 1; j < chunk.refs && chunk_lcp_x_reader.readLCPValue(lcp_x_value); ++j)
+		chunk.min_lcp_x = min(chunk.min_lcp_x, lcp_x_value);
 
+	if(derived_reader != nullptr) {
+		fclose(lcp_x_src_file);
+		fclose(id_x_file);
+	}
 	fclose(cLCP_x_file);
 	fclose(lcp_x_file);
 	fclose(d_file);
@@ -364,12 +727,66 @@ void MultiACS::forwardComputation(LetterNumber score_r[]) {
 	fclose(id_file);
 }
 
+void MultiACS::fixForwardChunk(ForwardChunk &chunk, const SequenceLength Q) {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceLength max_carry = *max_element(chunk.carry.begin(), chunk.carry.end());
+	if(max_carry == 0 || chunk.refs == 0)
+		return;
+
+	FILE* lcp_x_file = openFile(FileName(reference_lcp_column.file_name), "rb");
+	FILE* cLCP_x_file = openFile(FileName(params->workingFileName(reference_color), C_PartialCLcpFileExt), "r+b");
+	LCPReader lcp_x_reader(lcp_x_file, reference_lcp_column, chunk.h + 1);
+
+	PageArena page(Q, m);
+	SequenceLength prefix_lcp_x = C_MaxSequenceLength;
+	SequenceLength lcp_x_value;
+	for(SequenceLength j = 0; j < chunk.refs && min(max_carry, prefix_lcp_x) > 0; j += Q) {
+
+		SequenceLength rows = min<SequenceLength>(Q, chunk.refs - j);
+		LetterNumber offset = (LetterNumber) (chunk.h + j)*m*sizeof(SequenceLength);
+		if(fseeko(cLCP_x_file, (off_t) offset, SEEK_SET) != 0
+				|| fread(page.data(), sizeof(SequenceLength), (LetterNumber) rows*m, cLCP_x_file) != (LetterNumber) rows*m) {
+			ostringstream err_message;
+			err_message << "Incomplete partial cLCP rows " << chunk.h + j << "-" << chunk.h + j + rows - 1;
+			Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+		}
+
+		SequenceLength i = 0;
+		for(; i < rows; ++i) {
+			if(j + i > 0 && lcp_x_reader.readLCPValue(lcp_x_value))
+				prefix_lcp_x = min(prefix_lcp_x, lcp_x_value);
+			if(min(max_carry, prefix_lcp_x) == 0)
+				break;
+			SequenceLength* row = page.row(i);
+			maxMinRow(row, chunk.carry.data(), prefix_lcp_x, row, m);
+		}
+
+		if(fseeko(cLCP_x_file, (off_t) offset, SEEK_SET) != 0
+				|| fwrite(page.data(), sizeof(SequenceLength), (LetterNumber) i*m, cLCP_x_file) != (LetterNumber) i*m) {
+			ostringstream err_message;
+			err_message << "Couldn't write partial cLCP rows " << chunk.h + j << "-" << chunk.h + j + i - 1;
+			Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+		}
+	}
+
+	// The buffered rows are written when the file is closed
+	if(fclose(cLCP_x_file) != 0)
+		Error::stopWithError(C_MultiACS_ClassName, __func__, "Couldn't write the partial cLCP rows");
+	fclose(lcp_x_file);
+}
+
 void MultiACS::backwardComputation(LetterNumber score_x[]) {
 
+	if(params->tiled_clcp) {
+		tiledBackwardComputation(score_x);
+		return;
+	}
+
 	SequenceNumber m = global_collection.getSequenceNumber();
 	SequenceLength n_x = global_collection.getSequenceLength(reference_color);
 
-	FileName lcp_x_file_name(params->reference_sequence_file_name, C_LcpFileExt);
+	FileName lcp_x_file_name(reference_lcp_column.file_name);
 	FILE* lcp_x_file = fopen(lcp_x_file_name.c_str(), "rb");
 	if(lcp_x_file == nullptr) {
 		ostringstream err_message;
@@ -377,8 +794,10 @@ void MultiACS::backwardComputation(LetterNumber score_x[]) {
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 //	cout << "Reading from" << lcp_x_file_name.c_str() << endl;
+	LCPReader lcp_x_reader(lcp_x_file, reference_lcp_column);
 
-	FileName cLCP_x_file_name(params->output_file_name, C_PartialCLcpFileExt);
+	FileName cLCP_x_file_name(params->workingFileName(reference_color),
+			params->checkpoint_clcp ? C_CLcpCheckpointFileExt : C_PartialCLcpFileExt);
 	FILE* cLCP_x_file = fopen(cLCP_x_file_name.c_str(), "rb");
 	if(cLCP_x_file == nullptr) {
 		ostringstream err_message;
@@ -387,74 +806,377 @@ void MultiACS::backwardComputation(LetterNumber score_x[]) {
 	}
 //	cout << "Reading from" << cLCP_x_file_name.str() << endl;
 
-	AllocableMemory A = params->memory_amount/sizeof(SequenceLength);
+	// A sparse cLCP is rebuilt from the last row to the first one
+	FILE* cLCP_x_index_file = nullptr;
+	unique_ptr<SparseCLCPReader> cLCP_x_reader;
+	if(params->sparse_clcp) {
+		cLCP_x_index_file = openFile(FileName(params->workingFileName(reference_color), C_PartialCLcpIndexFileExt), "rb");
+		cLCP_x_reader.reset(new SparseCLCPReader(cLCP_x_file, cLCP_x_index_file, m, n_x));
+	}
 
-	SequenceLength Q = ceil((double) A/m);
+	// Pages of the forward computation are recomputed from their checkpoint
+	// by rescanning the target collection
+	unique_ptr<CLCPCheckpointReader> checkpoint_reader;
+	vector<FILE*> scan_files;
+	if(params->checkpoint_clcp) {
+		checkpoint_reader.reset(new CLCPCheckpointReader(cLCP_x_file, m));
+		scan_files.push_back(openFile(FileName(id_column.file_name), "rb"));
+		scan_files.push_back(openFile(FileName(lcp_column.file_name), "rb"));
+		scan_files.push_back(openFile(FileName(params->workingFileName(reference_color), C_DynBlockFileExt), "rb"));
+		scan_files.push_back(openFile(lcp_x_file_name, "rb"));
+	}
+
+	SequenceLength Q = checkpoint_reader ? checkpoint_reader->getPageRows() : params->backwardPageRows(m);
 	Q = Q > n_x ? n_x : Q;
+	SequenceLength page_rows = Q;
 
 	//SequenceLength cLCP_x[Q + 1][m];
-	vector<vector<SequenceLength>> cLCP_x(Q + 1, vector<SequenceLength>(m, 0));
-	SequenceLength lcp_x[Q + 1];
+	PageArena page_arena;
+	unique_ptr<CLCPPageReader> page_reader;
+	if(checkpoint_reader || cLCP_x_reader) {
+		page_arena.allocate(Q + 1, m);
+	}
+	else {
+		page_reader.reset(new CLCPPageReader(cLCP_x_file, m, Q + 1));
+		page_reader->prefetch(n_x - Q, Q);
+	}
+	vector<SequenceLength> lcp_x(Q + 1, 0);
 	SequenceLength H = ceil((double) n_x/Q);
+
+	// With -v the rows are appended to the trace of the forward computation
+	FILE* trace_file = params->verbose ? openFile(FileName(params->workingFileName(reference_color), C_TraceFileExt), "ab") : nullptr;
+	TraceWriter trace(trace_file);
 	SequenceLength q, e;
 	q = n_x;
 
+	// Colors are split in stripes, one for each worker, started once and
+	// handed every page. Each worker keeps its own score_x, merged at the
+	// end of the computation.
+	unsigned int T = params->threads;
+	T = T > m ? m : T;
+	T = T == 0 ? 1 : T;
+	vector<SequenceNumber> stripe(T + 1, 0);
+	for(unsigned int t = 0; t <= T; ++t)
+		stripe[t] = ((LetterNumber) m*t)/T;
+	vector<vector<LetterNumber>> thread_score_x(T);
+	for(unsigned int t = 0; t < T; ++t)
+		thread_score_x[t].assign(stripe[t + 1] - stripe[t], 0);
+	StripeWorkers workers(T);
+
 	cout << "cLCP Backward Computation\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+	cout << "Page arena: " << PageArena::currentBytes() << " bytes" << endl;
 
 
-	for(SequenceLength h = 1; h <= H ; ++h) {
+	for(SequenceLength h = 1; q > 0; ++h) {
 		//if (h % 1000 == 0)
 			//cout << "h = " << h << "\n";
+		// The last page of the forward computation may be shorter
+		Q = (checkpoint_reader && h == 1) ? n_x - (H - 1)*page_rows : page_rows;
 		if(Q > q)
 			Q = q;
 		q = q - Q;
 		// e = (h != H) ? 1 : 0;
 		e = (h != 1) ? 1 : 0;
-		fseek(cLCP_x_file, q*m*sizeof(SequenceLength), SEEK_SET);
-		fseek(lcp_x_file, q*sizeof(SequenceLength), SEEK_SET);
-		for(SequenceLength j = 0; j < Q + e; ++j)
-			fread(cLCP_x[j].data(), sizeof(SequenceLength), m, cLCP_x_file);
-		fread(lcp_x, sizeof(SequenceLength), Q + e, lcp_x_file);
-		for(SequenceLength k = Q; k > 0 ; --k) {
-			for(SequenceNumber r = 0; r < m; ++r) {
-				if(q + k == n_x) {
-					score_x[r] += cLCP_x[k - 1][r];
+		// Row Q is the first row of the page processed in the previous
+		// step, already updated by the backward propagation
+		PageArena &cLCP_x = page_reader ? page_reader->nextPage() : page_arena;
+		const PageArena &previous_page = page_reader ? page_reader->previousPage() : page_arena;
+		if(e)
+			copy(previous_page.row(0), previous_page.row(0) + m, cLCP_x.row(Q));
+		if(page_reader && q > 0) {
+			// Under memory pressure the pages read ahead are halved
+			if(MemoryGovernor::underPressure()) {
+				if(page_rows > 1) {
+					page_rows = page_rows/2;
+					page_reader->shrink(page_rows + 1);
+					MemoryGovernor::relieved();
 				}
 				else {
-					cLCP_x[k - 1][r] = max(min(cLCP_x[k][r], lcp_x[k]), cLCP_x[k - 1][r]);
-					score_x[r] += cLCP_x[k - 1][r];
+					MemoryGovernor::checkCeiling(C_MultiACS_ClassName, __func__);
 				}
 			}
-			if(params->verbose) {
-				cout << "[" << q + k - 1 << "]:";
-				for(SequenceNumber r = 0; r < m; ++r) {
-					cout << " " << cLCP_x[k - 1][r];
-				}
-				cout << endl;
-			}
+			page_reader->prefetch(q - min(page_rows, q), min(page_rows, q));
+		}
+		else if(MemoryGovernor::underPressure()) {
+			MemoryGovernor::checkCeiling(C_MultiACS_ClassName, __func__);
+		}
+		if(checkpoint_reader) {
+			recomputePage(*checkpoint_reader, scan_files, q, Q, cLCP_x);
+		}
+		else if(cLCP_x_reader) {
+			for(SequenceLength j = Q; j > 0; --j)
+				cLCP_x_reader->readPreviousCLCPRow(cLCP_x.row(j - 1));
+		}
+		for(SequenceLength j = 0; j < Q + e; ++j)
+			lcp_x[j] = lcp_x_reader.at(q + j);
+
+		workers.run([&](const unsigned int t) {
+			backwardStripe(cLCP_x, lcp_x.data(), Q, q, n_x,
+					stripe[t], stripe[t + 1], thread_score_x[t].data());
+		});
+
+		if(trace_file != nullptr) {
+			for(SequenceLength k = Q; k > 0 ; --k)
+				trace.backwardRow(q + k - 1, cLCP_x.row(k - 1), m);
 		}
 
 	}
 
+	for(unsigned int t = 0; t < T; ++t)
+		addScores(score_x + stripe[t], thread_score_x[t].data(), stripe[t + 1] - stripe[t]);
+
 	//delete [] cLCP_x;
 	cout << "END -------- cLCP Backward Computation\n";
 	
+	if(trace_file != nullptr)
+		fclose(trace_file);
+	if(cLCP_x_index_file != nullptr)
+		fclose(cLCP_x_index_file);
+	for(FILE* file : scan_files)
+		fclose(file);
 	fclose(cLCP_x_file);
 	fclose(lcp_x_file);
 
 }
 
+// Rows q..q+Q-1 of the partial cLCP, recomputed from the checkpoint of
+// their page (q is a multiple of the page size) by a forward scan of the
+// target collection, which stops once the row q+Q-1 is complete.
+// scan_files holds the id and lcp columns, the .d file and the reference LCP.
+void MultiACS::recomputePage(CLCPCheckpointReader &checkpoint_reader,
+		vector<FILE*> &scan_files,
+		const SequenceLength q,
+		const SequenceLength Q,
+		PageArena &cLCP_x) {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+
+	SequenceLength h = 0;
+	LetterNumber position = 0;
+	vector<SequenceLength> row_h(m, 0);
+	const LetterNumber page = q/checkpoint_reader.getPageRows();
+	if(page > 0 && !checkpoint_reader.readCheckpoint(page, h, position, row_h.data())) {
+		ostringstream err_message;
+		err_message << "Missing cLCP checkpoint of page " << page;
+		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	}
+	IdReader id_reader(scan_files[0], id_column, position);
+	LCPReader lcp_reader(scan_files[1], lcp_column, position);
+	DReader d_reader(scan_files[2], position);
+	LCPReader lcp_x_reader(scan_files[3], reference_lcp_column, page > 0 ? h + 1 : 0);
+
+	// One more row than the page, so that the scanner never flushes it
+	ForwardScanner scanner(reference_color, m, n_x, Q + 1, lcp_x_reader, nullptr, nullptr);
+	if(page > 0)
+		scanner.resume(h, row_h.data());
+	else
+		scanner.begin();
+
+	SequenceNumber id;
+	SequenceLength lcp_value, d_value;
+	while(scanner.getReferenceSuffixes() <= q + Q && id_reader.readSequenceId(id)
+			&& lcp_reader.readLCPValue(lcp_value) && d_reader.readDValue(d_value))
+		scanner.processSuffix(id, lcp_value, d_value);
+
+	for(SequenceLength j = 0; j < Q; ++j)
+		copy(scanner.getRow(j), scanner.getRow(j) + m, cLCP_x.row(j));
+}
+
+/* Backward computation on a partial cLCP stored by tiles of colors: the
+ * pages follow the alignment of the forward computation, so that the first
+ * one processed (the last page of the forward computation) may be shorter.
+ * Each tile of a page is swept from its last row to its first one while it
+ * stays in cache; carry holds the first row of the page processed before.
+ */
+void MultiACS::tiledBackwardComputation(LetterNumber score_x[]) {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	const SequenceLength n_x = global_collection.getSequenceLength(reference_color);
+
+	FILE* lcp_x_file = openFile(FileName(reference_lcp_column.file_name), "rb");
+	LCPReader lcp_x_reader(lcp_x_file, reference_lcp_column);
+	FILE* cLCP_x_file = openFile(FileName(params->workingFileName(reference_color), C_PartialCLcpFileExt), "rb");
+
+	const SequenceLength page_rows = forward_page_rows > n_x ? n_x : forward_page_rows;
+	const SequenceLength H = ceil((double) n_x/page_rows);
+	const SequenceNumber tiles = (m + tile_width - 1)/tile_width;
+
+	const SequenceLength top_rows = n_x - (H - 1)*page_rows;
+	CLCPPageReader page_reader(cLCP_x_file, m, page_rows);
+	page_reader.prefetch(n_x - top_rows, top_rows);
+	vector<SequenceLength> carry(m, 0);
+	vector<SequenceLength> lcp_x(page_rows + 1, 0);
+
+	// With -v the rows are appended to the trace of the forward computation
+	FILE* trace_file = params->verbose ? openFile(FileName(params->workingFileName(reference_color), C_TraceFileExt), "ab") : nullptr;
+	TraceWriter trace(trace_file);
+	vector<SequenceLength> trace_row(trace_file != nullptr ? m : 0, 0);
+
+	// Each worker, started once, sweeps a stripe of whole tiles of every page
+	unsigned int T = params->threads;
+	T = T > tiles ? tiles : T;
+	T = T == 0 ? 1 : T;
+	vector<SequenceNumber> stripe(T + 1, 0);
+	for(unsigned int t = 0; t <= T; ++t)
+		stripe[t] = min((SequenceNumber) ((((LetterNumber) tiles*t)/T)*tile_width), m);
+	StripeWorkers workers(T);
+
+	cout << "cLCP Backward Computation\n";
+	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+	cout << "Page arena: " << PageArena::currentBytes() << " bytes" << endl;
+
+	SequenceLength q = n_x;
+	for(SequenceLength h = 1; h <= H; ++h) {
+		const SequenceLength rows = (h == 1) ? top_rows : page_rows;
+		q = q - rows;
+		const bool top_page = (h == 1);
+		PageArena &page = page_reader.nextPage();
+		// The tiled pages keep the rows of the forward computation
+		if(MemoryGovernor::underPressure())
+			MemoryGovernor::checkCeiling(C_MultiACS_ClassName, __func__);
+		if(q > 0)
+			page_reader.prefetch(q - page_rows, page_rows);
+		for(SequenceLength j = 0; j < rows + (top_page ? 0 : 1); ++j)
+			lcp_x[j] = lcp_x_reader.at(q + j);
+
+		workers.run([&](const unsigned int t) {
+			backwardTiles(page.data(), carry.data(), lcp_x.data(), rows, top_page,
+					stripe[t], stripe[t + 1], score_x);
+		});
+
+		if(trace_file != nullptr) {
+			for(SequenceLength k = rows; k > 0 ; --k) {
+				for(SequenceNumber r = 0; r < m; ++r) {
+					const SequenceNumber c = r - r % tile_width;
+					const SequenceNumber width = min<SequenceNumber>(tile_width, m - c);
+					trace_row[r] = page.data()[(LetterNumber) rows*c + (LetterNumber) (k - 1)*width + r - c];
+				}
+				trace.backwardRow(q + k - 1, trace_row.data(), m);
+			}
+		}
+	}
+
+	cout << "END -------- cLCP Backward Computation\n";
+
+	if(trace_file != nullptr)
+		fclose(trace_file);
+	fclose(cLCP_x_file);
+	fclose(lcp_x_file);
+}
+
+// Tiles of the colors first_color..last_color-1 of a page of the given rows
+void MultiACS::backwardTiles(SequenceLength page[],
+		SequenceLength carry[],
+		const SequenceLength lcp_x[],
+		const SequenceLength rows,
+		const bool top_page,
+		const SequenceNumber first_color,
+		const SequenceNumber last_color,
+		LetterNumber score_x[]) {
+
+	const SequenceNumber m = global_collection.getSequenceNumber();
+	for(SequenceNumber c = first_color; c < last_color; c += tile_width) {
+		const SequenceNumber width = min<SequenceNumber>(tile_width, m - c);
+		SequenceLength* tile = page + (LetterNumber) rows*c;
+		for(SequenceLength k = rows; k > 0; --k) {
+			SequenceLength* cur_row = tile + (LetterNumber) (k - 1)*width;
+			if(k < rows)
+				maxMinRowScore(cur_row, cur_row + width, lcp_x[k], cur_row, score_x + c, width);
+			else if(top_page)
+				addRow(score_x + c, cur_row, width);
+			else
+				maxMinRowScore(cur_row, carry + c, lcp_x[k], cur_row, score_x + c, width);
+		}
+		copy(tile, tile + width, carry + c);
+	}
+}
+
+void MultiACS::backwardStripe(PageArena &cLCP_x,
+		const SequenceLength lcp_x[],
+		const SequenceLength Q,
+		const SequenceLength q,
+		const SequenceLength n_x,
+		const SequenceNumber first_color,
+		const SequenceNumber last_color,
+		LetterNumber score_x[]) {
+
+	// score_x is local to the stripe: score_x[0] refers to first_color
+	for(SequenceLength k = Q; k > 0 ; --k) {
+		SequenceLength* cur_row = cLCP_x.row(k - 1);
+		if(q + k == n_x) {
+			addRow(score_x, cur_row + first_color, last_color - first_color);
+		}
+		else {
+			const SequenceLength* next_row = cLCP_x.row(k);
+			maxMinRowScore(cur_row + first_color, next_row + first_color, lcp_x[k],
+					cur_row + first_color, score_x, last_color - first_color);
+		}
+	}
+}
+
 
 
 } /* namespace multi_acs */
 
 void printUsage() {
-	cout << "Usage: [-h] [-v] [-p] [-l] [-f input_format] [-Q amount] ref_seq target_seqs ref_color output" << endl;
+	cout << "Usage: [-h] [-v] [-p] [-l] [-f input_format] [-Q amount | --mem amount] [--mem-ceiling amount] [--scratch amount] [--plan] [-t threads] [--sparse-xclcp | --checkpoint-xclcp | --tiled-xclcp] [--d-stack-memory amount] ref_seq target_seqs ref_color output" << endl;
+	cout << "       [-h] [-v] [-p] [-l] [-f input_format] [-Q amount | --mem amount] [--mem-ceiling amount] [--scratch amount] [--plan] [-t threads] [--sparse-xclcp | --checkpoint-xclcp | --tiled-xclcp] [--d-stack-memory amount] --derive-lcp target_seqs ref_color output" << endl;
+	cout << "       [-h] [-v] [-p] [-l] [-f input_format] [--mem amount] [--mem-ceiling amount] [--scratch amount] [--plan] [--d-stack-memory amount] --all-vs-all target_seqs output" << endl;
 }
 
+// Long options without a short equivalent
+enum LongOption {
+	C_AllVsAllOption = 256,
+	C_DeriveLCPOption,
+	C_SparseCLCPOption,
+	C_CheckpointCLCPOption,
+	C_DStackMemoryOption,
+	C_TiledCLCPOption,
+	C_MemOption,
+	C_ScratchOption,
+	C_PlanOption,
+	C_MemCeilingOption
+};
+
 using namespace multi_acs;
 
+// Items of a comma separated list
+vector<string> splitList(const string &list) {
+	vector<string> items;
+	istringstream stream(list);
+	string item;
+	while(getline(stream, item, ','))
+		items.push_back(item);
+	return items;
+}
+
+// Unsigned decimal argument of an option, checked for the whole 64 bits.
+// Amounts of bytes may end with a binary unit: K, M, G or T (e.g. 64G)
+unsigned long long parseNumber(const char* arg, const char* option, const bool units = false) {
+	char* end = nullptr;
+	errno = 0;
+	unsigned long long value = strtoull(arg, &end, 10);
+	bool valid = end != arg && errno != ERANGE && arg[strspn(arg, " \t")] != '-';
+	const char* unit_symbols = "KMGT";
+	const char* unit = (units && *end != '\0') ? strchr(unit_symbols, toupper(*end)) : nullptr;
+	if(valid && unit != nullptr) {
+		const unsigned int shift = 10*(unit - unit_symbols + 1);
+		valid = value <= (C_MaxLetterNumber >> shift);
+		value <<= shift;
+		++end;
+		if(toupper(*end) == 'B')
+			++end;
+	}
+	if(!valid || *end != '\0') {
+		ostringstream err_message;
+		err_message << "Invalid " << option << " value " << arg;
+		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+	}
+	return value;
+}
+
 int main(int argc, char* argv[]) {
 
 	bool verbose = false;
@@ -463,10 +1185,37 @@ int main(int argc, char* argv[]) {
 	int input_format = 1;
 	string reference_seq_file_name, target_collection_file_name, output_file_name;
 	SequenceNumber reference_color;
+	vector<string> reference_seq_file_names, reference_color_list;
 	AllocableMemory memory_amount = BUFFER_SIZE*sizeof(SequenceLength);
+	unsigned int threads = 1;
+	bool all_vs_all = false;
+	bool derive_lcp = false;
+	bool sparse_clcp = false;
+	bool checkpoint_clcp = false;
+	bool tiled_clcp = false;
+	AllocableMemory d_stack_memory = C_DefaultDStackMemory;
+	bool memory_given = false;
+	AllocableMemory mem_budget = 0;
+	LetterNumber scratch_budget = 0;
+	bool plan = false;
+	AllocableMemory mem_ceiling = 0;
+
+	const struct option long_options[] = {
+		{"all-vs-all", no_argument, nullptr, C_AllVsAllOption},
+		{"derive-lcp", no_argument, nullptr, C_DeriveLCPOption},
+		{"sparse-xclcp", no_argument, nullptr, C_SparseCLCPOption},
+		{"checkpoint-xclcp", no_argument, nullptr, C_CheckpointCLCPOption},
+		{"d-stack-memory", required_argument, nullptr, C_DStackMemoryOption},
+		{"tiled-xclcp", no_argument, nullptr, C_TiledCLCPOption},
+		{"mem", required_argument, nullptr, C_MemOption},
+		{"scratch", required_argument, nullptr, C_ScratchOption},
+		{"plan", no_argument, nullptr, C_PlanOption},
+		{"mem-ceiling", required_argument, nullptr, C_MemCeilingOption},
+		{nullptr, 0, nullptr, 0}
+	};
 
 	int o;
-	while((o = getopt(argc, argv, "vhplf:Q:")) != -1) {
+	while((o = getopt_long(argc, argv, "vhplf:Q:t:", long_options, nullptr)) != -1) {
 		switch(o) {
 			case 'v':
 				verbose = true;
@@ -481,7 +1230,48 @@ int main(int argc, char* argv[]) {
 				lengths_provided = true;
 				break;
 			case 'Q':
-				memory_amount = atoi(optarg);
+				memory_amount = parseNumber(optarg, "-Q", true);
+				memory_given = true;
+				break;
+			case 't': {
+				const unsigned long long requested = parseNumber(optarg, "-t");
+				if(requested == 0 || requested > UINT_MAX) {
+					ostringstream err_message;
+					err_message << "Invalid -t value " << optarg;
+					Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+				}
+				threads = requested;
+				break;
+			}
+			case C_AllVsAllOption:
+				all_vs_all = true;
+				break;
+			case C_DeriveLCPOption:
+				derive_lcp = true;
+				break;
+			case C_SparseCLCPOption:
+				sparse_clcp = true;
+				break;
+			case C_CheckpointCLCPOption:
+				checkpoint_clcp = true;
+				break;
+			case C_TiledCLCPOption:
+				tiled_clcp = true;
+				break;
+			case C_DStackMemoryOption:
+				d_stack_memory = parseNumber(optarg, "--d-stack-memory", true);
+				break;
+			case C_MemOption:
+				mem_budget = parseNumber(optarg, "--mem", true);
+				break;
+			case C_ScratchOption:
+				scratch_budget = parseNumber(optarg, "--scratch", true);
+				break;
+			case C_PlanOption:
+				plan = true;
+				break;
+			case C_MemCeilingOption:
+				mem_ceiling = parseNumber(optarg, "--mem-ceiling", true);
 				break;
 			case 'h':
 			default:
@@ -496,36 +1286,57 @@ int main(int argc, char* argv[]) {
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
-	if(optind == argc - 4) {
-		reference_seq_file_name = string(argv[optind++]);
+	if(memory_given && mem_budget > 0) {
+		ostringstream err_message;
+		err_message << "Options -Q and --mem should not be used simultaneously";
+		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
-	else {
-		printUsage();
+
+	if((sparse_clcp ? 1 : 0) + (checkpoint_clcp ? 1 : 0) + (tiled_clcp ? 1 : 0) > 1) {
 		ostringstream err_message;
-		err_message << "Missing Reference Sequence file name";
+		err_message << "Options --sparse-xclcp, --checkpoint-xclcp and --tiled-xclcp should not be used simultaneously";
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
-	if(optind == argc - 3) {
-		target_collection_file_name = string(argv[optind++]);
+	if(all_vs_all) {
+		// Every sequence of the target collection is a reference
+		reference_color = FIRST_COLOR;
+	}
+	else if(derive_lcp) {
+		// The LCP of the references is derived from the target collection
+	}
+	else if(optind == argc - 4) {
+		reference_seq_file_names = splitList(string(argv[optind++]));
 	}
 	else {
 		printUsage();
 		ostringstream err_message;
-		err_message << "Missing target collection file name";
+		err_message << "Missing Reference Sequence file name";
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
-	if(optind == argc - 2) {
-		reference_color = atoi(argv[optind++]);
+	if(optind == argc - (all_vs_all ? 2 : 3)) {
+		target_collection_file_name = string(argv[optind++]);
 	}
 	else {
 		printUsage();
 		ostringstream err_message;
-		err_message << "Missing reference color";
+		err_message << "Missing target collection file name";
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
+	if(!all_vs_all) {
+		if(optind == argc - 2) {
+			reference_color_list = splitList(string(argv[optind++]));
+		}
+		else {
+			printUsage();
+			ostringstream err_message;
+			err_message << "Missing reference color";
+			Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+		}
+	}
+
 	if(optind == argc - 1) {
 		output_file_name = string(argv[optind++]);
 	}
@@ -536,37 +1347,75 @@ int main(int argc, char* argv[]) {
 		Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
 	}
 
+	vector<SequenceNumber> reference_colors;
+	if(!all_vs_all) {
+		if(reference_color_list.empty() || (!derive_lcp &&
+				reference_seq_file_names.size() != reference_color_list.size())) {
+			printUsage();
+			ostringstream err_message;
+			err_message << "Reference Sequence file names and reference colors should be paired";
+			Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+		}
+		for(const string &color : reference_color_list) {
+			const unsigned long long reference = parseNumber(color.c_str(), "reference color");
+			if(reference >= C_MaxSequenceNumber) {
+				ostringstream err_message;
+				err_message << "Reference color " << reference << " exceeds the colors of this build";
+				Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+			}
+			reference_colors.push_back(reference);
+			if(count(reference_colors.begin(), reference_colors.end(), reference_colors.back()) > 1) {
+				ostringstream err_message;
+				err_message << "Reference color " << reference_colors.back() << " given twice";
+				Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+			}
+		}
+		if(!derive_lcp)
+			reference_seq_file_name = reference_seq_file_names[0];
+		reference_color = reference_colors[0];
+	}
+
 	MultiACSParameters* params = new MultiACSParameters(verbose,
 			reference_seq_file_name,
 			target_collection_file_name,
 			input_format,
 			reference_color,
 			output_file_name, memory_amount);
-	params->printParameters();
+	params->threads = threads > 0 ? threads : 1;
+	params->all_vs_all = all_vs_all;
+	params->derive_lcp = derive_lcp && !all_vs_all;
+	params->sparse_clcp = sparse_clcp;
+	params->checkpoint_clcp = checkpoint_clcp;
+	params->tiled_clcp = tiled_clcp;
+	params->d_stack_memory = d_stack_memory;
+	// The id and lcp columns of a GESA are read in place, without extraction
+	params->gesa_columns = (input_format == 1) && !lengths_provided;
+	if(!all_vs_all) {
+		params->reference_colors = reference_colors;
+		params->reference_sequence_file_names = reference_seq_file_names;
+	}
+	// The plan may change the pages, the workers and the partial cLCP format
+	const bool planning = plan || mem_budget > 0 || scratch_budget > 0;
+	if(!planning)
+		params->printParameters();
 
-	// Build separated files from GESA file
-	if((input_format == 1) && (!preprocessed) && (!lengths_provided)) {
-		GESAConverter::extractFromGESA(reference_seq_file_name);
-		GESAConverter::extractFromGESA(target_collection_file_name);
+	for(const string &file_name : reference_seq_file_names) {
+		CollectionInfo reference_sequence(file_name,
+			input_format,
+			false,	// do not collect symbols/colors frequencies
+			params->verbose);
 	}
-	
-	CollectionInfo reference_sequence(reference_seq_file_name,
-		input_format,
-		false,	// do not collect symbols/colors frequencies
-		params->verbose);
 
 	CollectionInfo* collection;
+	CollectionInfo* scanned_collection = nullptr;
 	if(!preprocessed && !lengths_provided) {
+		// The symbols and colors of a GESA are collected by the scan below
 		collection = new CollectionInfo(params->target_collection_file_name,
 				input_format,
-				true,
+				input_format != 1,
 				params->verbose);
-		if(collection->colors.count(params->reference_color) == 0) {
-			ostringstream err_message;
-			err_message << "Couldn't find reference color in target collection";
-			Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
-		}
-		collection->saveCollectionInfo();
+		if(input_format == 1)
+			scanned_collection = collection;
 	}
 	else {
 		if(lengths_provided) {
@@ -578,6 +1427,62 @@ int main(int argc, char* argv[]) {
 			collection = new CollectionInfo(params->target_collection_file_name, input_format, params->verbose);
 		}
 	}
+
+	// The plan needs the sizes of the target collection before the D files
+	// are generated, so its GESA is scanned on its own
+	if(planning) {
+		if(scanned_collection != nullptr) {
+			vector<StackedDGenerator*> no_d_generators;
+			GESAConverter::preprocessGESA(params->target_collection_file_name,
+					scanned_collection, false, no_d_generators);
+			scanned_collection = nullptr;
+		}
+		Planner planner(params, *collection);
+		if(mem_budget > 0)
+			planner.fitMemory(mem_budget);
+		if(scratch_budget > 0 && planner.fitScratch(scratch_budget) && mem_budget > 0)
+			planner.fitMemory(mem_budget);
+		params->printParameters();
+		planner.printPlan();
+		if(plan) {
+			if(!preprocessed && !lengths_provided)
+				collection->saveCollectionInfo();
+			return EXIT_SUCCESS;
+		}
+	}
+
+	// The pages give back memory above 7/8 of the ceiling, --mem by default
+	if(mem_ceiling == 0)
+		mem_ceiling = mem_budget;
+	if(mem_ceiling > 0)
+		MemoryGovernor::arm(mem_ceiling);
+
+	// One scan of the target GESA collects its symbols and colors and
+	// generates the D file of every reference, unless several workers
+	// generate the D files of all the references by one chunked pass
+	const bool generate_d = !all_vs_all && !params->inlineD();
+	vector<StackedDGenerator*> d_generators;
+	if(generate_d && params->threads <= 1)
+		for(const SequenceNumber color : params->reference_colors)
+			d_generators.push_back(new StackedDGenerator(params, color));
+	if(scanned_collection != nullptr || !d_generators.empty())
+		GESAConverter::preprocessGESA(params->target_collection_file_name,
+				scanned_collection, false, d_generators);
+	for(StackedDGenerator* d_generator : d_generators)
+		delete d_generator;
+	if(generate_d && params->threads > 1)
+		StackedDGenerator::generateD(params, params->reference_colors);
+
+	if(!preprocessed && !lengths_provided) {
+		for(const SequenceNumber color : reference_colors) {
+			if(collection->colors.count(color) == 0) {
+				ostringstream err_message;
+				err_message << "Couldn't find reference color " << color << " in target collection";
+				Error::stopWithError(C_MultiACS_ClassName, __func__, err_message.str());
+			}
+		}
+		collection->saveCollectionInfo();
+	}
 	collection->printCollectionInfo();
 
 	clock_t start = clock();
@@ -587,13 +1492,14 @@ int main(int argc, char* argv[]) {
 	cout << "Global Computation Starting\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
 
-/**/
-	StackedDGenerator d_gen(params);
-	d_gen.generateD();
-/**/
-
-	MultiACS acs(params, *collection);
-	acs.computeACS();
+	if(all_vs_all) {
+		MultiACS acs(params, *collection);
+		acs.computeAllVsAll();
+	}
+	else {
+		MultiACS acs(params, *collection);
+		acs.computeACS();
+	}
 
 	cout << "Global Computation End\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
@@ -605,6 +1511,10 @@ int main(int argc, char* argv[]) {
 	cout << "Elapsed time: " << elapsed << " secs\n";
 	cout << "Wall Clock time: " << elapsed_wc << " secs\n";
 	cout << "Peak memory: " << malloc_count_peak() << " bytes\n";
+	cout << "Peak page arena memory: " << PageArena::peakBytes() << " bytes\n";
+	if(MemoryGovernor::armed())
+		cout << "Memory reliefs: " << MemoryGovernor::getReliefs() << " (ceiling "
+				<< MemoryGovernor::getCeiling() << " bytes)\n";
 	cout << endl;
 
 }
@@ -43,7 +43,11 @@
 
 #include "Parameters.h"
 #include "CollectionInfo.h"
+#include "ForwardScanner.h"
+#include "PageArena.h"
+#include "Tools.h"
 #include "Types.h"
+#include <vector>
 
 namespace multi_acs {
 
@@ -58,16 +62,72 @@ public:
 	MultiACSParameters* params;
 	CollectionInfo global_collection;
 	SequenceNumber reference_color;
+	// References of the run (every color in all-vs-all mode)
+	std::vector<SequenceNumber> reference_colors;
+	// Columns of the target collection, and LCP of the current reference
+	ColumnFile id_column;
+	ColumnFile lcp_column;
+	ColumnFile reference_lcp_column;
+	// Rows of the pages of the forward computation, and colors of their
+	// tiles when the partial cLCP is tiled
+	SequenceLength forward_page_rows{0};
+	SequenceNumber tile_width{0};
 
 	void computeACS();
+	void computeAllVsAll();
 
 private:
 
-	void generateD();
+	void generateD(const std::vector<SequenceNumber> &colors);
 	void generateLCP();
+	void setReference(const SequenceNumber k);
+	ColumnFile idColumn(const std::string &collection_file_name) const;
+	ColumnFile lcpColumn(const std::string &collection_file_name) const;
+	ColumnFile referenceLCPColumn(const SequenceNumber k) const;
 
-	void forwardComputation(LetterNumber score_r[]);
+	FILE* openFile(const FileName &file_name, const char* mode);
+
+	void forwardComputation(std::vector<std::vector<LetterNumber>> &score_r);
+	void forwardScan(const SequenceNumber first,
+			const SequenceNumber last,
+			const SequenceLength Q,
+			std::vector<std::vector<LetterNumber>> &score_r,
+			PageRelief &relief);
 	void backwardComputation(LetterNumber score_x[]);
+	void writeDistances(FILE* distance_file,
+			const LetterNumber score_x[],
+			const LetterNumber score_r[]);
+
+	void parallelForwardComputation(LetterNumber score_r[], const SequenceLength Q);
+	void countReferenceSuffixes(const LetterNumber start,
+			const LetterNumber end,
+			SequenceLength &refs,
+			LetterNumber &first_pos);
+	void forwardChunk(ForwardChunk &chunk, const SequenceLength Q, PageRelief &relief);
+	void fixForwardChunk(ForwardChunk &chunk, const SequenceLength Q);
+
+	void recomputePage(CLCPCheckpointReader &checkpoint_reader,
+			std::vector<FILE*> &scan_files,
+			const SequenceLength q,
+			const SequenceLength Q,
+			PageArena &cLCP_x);
+	void backwardStripe(PageArena &cLCP_x,
+			const SequenceLength lcp_x[],
+			const SequenceLength Q,
+			const SequenceLength q,
+			const SequenceLength n_x,
+			const SequenceNumber first_color,
+			const SequenceNumber last_color,
+			LetterNumber score_x[]);
+	void tiledBackwardComputation(LetterNumber score_x[]);
+	void backwardTiles(SequenceLength page[],
+			SequenceLength carry[],
+			const SequenceLength lcp_x[],
+			const SequenceLength rows,
+			const bool top_page,
+			const SequenceNumber first_color,
+			const SequenceNumber last_color,
+			LetterNumber score_x[]);
 };
 
 } /* namespace multi_acs */
@@ -0,0 +1,126 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "PageArena.h"
+#include "Tools.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+using namespace std;
+
+namespace multi_acs {
+
+atomic<LetterNumber> PageArena::current_bytes{0};
+atomic<LetterNumber> PageArena::peak_bytes{0};
+
+PageArena::PageArena(const SequenceLength rows, const SequenceNumber m) {
+	allocate(rows, m);
+}
+
+PageArena::~PageArena() {
+	release();
+}
+
+void PageArena::allocate(const SequenceLength rows, const SequenceNumber m) {
+	release();
+	this->rows = rows;
+	this->m = m;
+	const LetterNumber bytes = (LetterNumber) rows*m*sizeof(SequenceLength);
+	if(bytes == 0)
+		return;
+
+	void* address = MAP_FAILED;
+	if(bytes >= C_HugePageSize) {
+		map_length = (bytes + C_HugePageSize - 1)/C_HugePageSize*C_HugePageSize;
+		address = mmap(nullptr, map_length, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		huge_pages = (address != MAP_FAILED);
+	}
+	if(address == MAP_FAILED) {
+		const LetterNumber page_size = sysconf(_SC_PAGESIZE);
+		map_length = (bytes + page_size - 1)/page_size*page_size;
+		address = mmap(nullptr, map_length, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(address == MAP_FAILED) {
+			ostringstream err_message;
+			err_message << "Couldn't map " << map_length << " bytes: " << strerror(errno);
+			Error::stopWithError(C_PageArena_ClassName, __func__, err_message.str());
+		}
+#ifdef MADV_HUGEPAGE
+		if(bytes >= C_HugePageSize)
+			madvise(address, map_length, MADV_HUGEPAGE);
+#endif
+	}
+	values = static_cast<SequenceLength*>(address);
+
+	const LetterNumber current = (current_bytes += map_length);
+	LetterNumber peak = peak_bytes;
+	while(current > peak && !peak_bytes.compare_exchange_weak(peak, current)) { }
+}
+
+void PageArena::swap(PageArena &other) {
+	std::swap(values, other.values);
+	std::swap(rows, other.rows);
+	std::swap(m, other.m);
+	std::swap(map_length, other.map_length);
+	std::swap(huge_pages, other.huge_pages);
+}
+
+void PageArena::release() {
+	if(values != nullptr) {
+		munmap(values, map_length);
+		current_bytes -= map_length;
+	}
+	values = nullptr;
+	rows = 0;
+	map_length = 0;
+	huge_pages = false;
+}
+
+LetterNumber PageArena::mappedBytes(const SequenceLength rows, const SequenceNumber m) {
+	const LetterNumber bytes = (LetterNumber) rows*m*sizeof(SequenceLength);
+	const LetterNumber page_size = bytes >= C_HugePageSize ? C_HugePageSize : sysconf(_SC_PAGESIZE);
+	return (bytes + page_size - 1)/page_size*page_size;
+}
+
+} /* namespace multi_acs */
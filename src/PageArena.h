@@ -0,0 +1,96 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#ifndef PAGEARENA_H_
+#define PAGEARENA_H_
+
+#include "Types.h"
+#include <atomic>
+
+namespace multi_acs {
+
+const char C_PageArena_ClassName[]{"PageArena"};
+const LetterNumber C_HugePageSize{2 << 20};
+
+// Zeroed, contiguous rows of m values of the cLCP passes, mapped outside of
+// the heap and aligned to the page size, so that a page of the partial cLCP
+// is read or written with one I/O. Arenas of at least one huge page are
+// backed by huge pages when the system provides them (MAP_HUGETLB), or
+// marked for transparent huge pages otherwise (MADV_HUGEPAGE).
+class PageArena {
+public:
+	PageArena() { }
+	PageArena(const SequenceLength rows, const SequenceNumber m);
+	~PageArena();
+
+	PageArena(const PageArena&) = delete;
+	PageArena& operator=(const PageArena&) = delete;
+
+	void allocate(const SequenceLength rows, const SequenceNumber m);
+	void release();
+	void swap(PageArena &other);
+
+	SequenceLength* row(const SequenceLength i) { return values + (LetterNumber) i*m; }
+	const SequenceLength* row(const SequenceLength i) const { return values + (LetterNumber) i*m; }
+	SequenceLength* data() { return values; }
+	const SequenceLength* data() const { return values; }
+	LetterNumber size() const { return (LetterNumber) rows*m; }
+	bool hugePages() const { return huge_pages; }
+
+	// Bytes mapped by all the arenas, which malloc_count does not see
+	static LetterNumber currentBytes() { return current_bytes; }
+	static LetterNumber peakBytes() { return peak_bytes; }
+	// Bytes mapped for an arena of the given rows, at most
+	static LetterNumber mappedBytes(const SequenceLength rows, const SequenceNumber m);
+
+private:
+	SequenceLength* values{nullptr};
+	SequenceLength rows{0};
+	SequenceNumber m{0};
+	LetterNumber map_length{0};
+	bool huge_pages{false};
+
+	static std::atomic<LetterNumber> current_bytes;
+	static std::atomic<LetterNumber> peak_bytes;
+};
+
+} /* namespace multi_acs */
+
+#endif /* PAGEARENA_H_ */
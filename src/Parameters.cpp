@@ -40,8 +40,11 @@
  **/
 #include "Parameters.h"
 #include "Types.h"
+#include "RowKernels.h"
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
@@ -93,24 +96,92 @@ MultiACSParameters::MultiACSParameters(const bool verbose,
 				file_format(file_format),
 				reference_color(reference_color),
 				output_file_name(output_file_name),
-				memory_amount(memory_amount) { }
+				memory_amount(memory_amount),
+				reference_colors(1, reference_color),
+				reference_sequence_file_names(1, reference_sequence_file_name) { }
 
 MultiACSParameters::~MultiACSParameters() {
 	// TODO Auto-generated destructor stub
 }
 
+string MultiACSParameters::workingFileName(const SequenceNumber color) const {
+	if(!all_vs_all && reference_colors.size() == 1)
+		return output_file_name;
+	return output_file_name + "_" + to_string(color);
+}
+
+// Verbose reporting follows the order of the suffixes, and a sparse cLCP,
+// its checkpoints or its tiled pages are written in that order: no chunks
+bool MultiACSParameters::chunkedForward() const {
+	return !all_vs_all && reference_colors.size() == 1 && threads > 1 && !verbose
+			&& !sparse_clcp && !checkpoint_clcp && !tiled_clcp;
+}
+
+// At least two rows for each reference of a scan
+SequenceNumber MultiACSParameters::scanReferences(const SequenceNumber K, const SequenceNumber m) const {
+	const AllocableMemory A = memory_amount/sizeof(SequenceLength);
+	SequenceNumber B = min(K, C_MaxScanReferences);
+	if(!all_vs_all && (AllocableMemory) B*2*m > A)
+		B = max(A/(2*m), (AllocableMemory) 1);
+	return B;
+}
+
+SequenceLength MultiACSParameters::forwardPageRows(const SequenceNumber K, const SequenceNumber m) const {
+	if(all_vs_all)
+		return 0;
+	const AllocableMemory A = memory_amount/sizeof(SequenceLength);
+	// Rows beyond the longest length are never used
+	const AllocableMemory rows = ceil((double) A/((LetterNumber) scanReferences(K, m)*m));
+	SequenceLength Q = min(rows, (AllocableMemory) C_MaxSequenceLength - 1);
+	// A written page is drained by a writer thread while the next one is
+	// filled, and a recomputed page is held together with the page of the
+	// backward computation
+	return Q/2 > 0 ? Q/2 : 1;
+}
+
+SequenceLength MultiACSParameters::backwardPageRows(const SequenceNumber m) const {
+	const AllocableMemory A = memory_amount/sizeof(SequenceLength);
+	SequenceLength Q = min((AllocableMemory) ceil((double) A/m), (AllocableMemory) C_MaxSequenceLength - 1);
+	// A page is read ahead while the one before is processed, a sparse
+	// cLCP is rebuilt in place
+	if(!sparse_clcp)
+		Q = Q/2;
+	return Q > 0 ? Q : 1;
+}
+
 void MultiACSParameters::printParameters() {
 
 	cout << "----- OPTIONS RESUME -----\n";
-	cout << "Reference Sequence file path: "
-			<< reference_sequence_file_name << '\n';
+	if(derive_lcp)
+		cout << "Reference Sequence LCP: derived from Target Collection\n";
+	else if(!all_vs_all) {
+		cout << "Reference Sequence file path:";
+		for(const string &file_name : reference_sequence_file_names)
+			cout << " " << file_name;
+		cout << '\n';
+	}
 	cout << "Target Collection file path: "
 			<< target_collection_file_name << '\n';
-	cout << "Reference Sequence Color: "
-			<< reference_color << '\n';
+	if(all_vs_all)
+		cout << "Reference Sequence Color: ALL (all-vs-all)\n";
+	else {
+		cout << "Reference Sequence Color:";
+		for(const SequenceNumber color : reference_colors)
+			cout << " " << color;
+		cout << '\n';
+	}
 	cout << "Output file path: "
 			<< output_file_name << '\n';
 	cout << "Max Usable Memory in ACS Computing: " << memory_amount << " Byte\n";
+	cout << "Worker Threads: " << threads << '\n';
+	cout << "Row Kernels: " << rowKernels().name << '\n';
+	cout << "Max Memory of D Interval Stack: " << d_stack_memory << " Byte\n";
+	if(sparse_clcp)
+		cout << "Partial cLCP format: sparse\n";
+	if(checkpoint_clcp)
+		cout << "Partial cLCP format: checkpoints, pages recomputed\n";
+	if(tiled_clcp)
+		cout << "Partial cLCP format: tiles of colors\n";
 	if(verbose)
 		cout << "***WITH VERBOSE REPORTING***\n";
 	cout << "--- END OPTIONS RESUME ---" << endl;
@@ -43,9 +43,14 @@
 
 #include "Types.h"
 #include <string>
+#include <vector>
 
 namespace multi_acs {
 
+// Maximum number of references served by one scan of the target collection
+// (each one keeps its own D stream open)
+const SequenceNumber C_MaxScanReferences{64};
+
 
 class GapParameters {
 public:
@@ -79,7 +84,45 @@ public:
 	const int file_format;
 	const SequenceNumber reference_color;
 	const std::string output_file_name;
-	const AllocableMemory memory_amount;
+	// Memory of the partial cLCP pages (-Q), set by the planner with --mem
+	AllocableMemory memory_amount;
+
+	// Number of worker threads used by the cLCP passes
+	unsigned int threads{1};
+	// The id and lcp columns are read in place from the .gesa files
+	bool gesa_columns{false};
+	// Every sequence of the target collection is used as reference
+	bool all_vs_all{false};
+	// The LCP of the references is derived from the target collection
+	bool derive_lcp{false};
+	// The partial cLCP is stored as row differences (SparseCLCPWriter)
+	bool sparse_clcp{false};
+	// Only checkpoints of the partial cLCP are stored, the backward
+	// computation recomputes its pages (CLCPCheckpointWriter)
+	bool checkpoint_clcp{false};
+	// The pages of the partial cLCP are stored by tiles of colors
+	bool tiled_clcp{false};
+	// Memory of the interval stack of each D generator, the rest is
+	// spilled to disk
+	AllocableMemory d_stack_memory{C_DefaultDStackMemory};
+	// Reference colors served by one run, with their GESA file names
+	std::vector<SequenceNumber> reference_colors;
+	std::vector<std::string> reference_sequence_file_names;
+
+	// Name of the working files (.d, .xclcp) of a reference color
+	std::string workingFileName(const SequenceNumber color) const;
+	// The forward computation of a single reference is split in chunks
+	bool chunkedForward() const;
+	// D is computed during the forward scan, no .d file is written: the
+	// chunks and the recomputed pages read D from any position
+	bool inlineD() const { return !chunkedForward() && (all_vs_all || !checkpoint_clcp); }
+	// References served by one scan of K references over m colors, and
+	// rows of each of their forward pages (0 when no row is kept)
+	SequenceNumber scanReferences(const SequenceNumber K, const SequenceNumber m) const;
+	SequenceLength forwardPageRows(const SequenceNumber K, const SequenceNumber m) const;
+	// Rows of the pages read back by the backward computation over m colors,
+	// at least one even below m values of memory
+	SequenceLength backwardPageRows(const SequenceNumber m) const;
 	void printParameters();
 };
 
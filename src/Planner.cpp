@@ -0,0 +1,321 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "Planner.h"
+#include "Tools.h"
+#include "PageArena.h"
+#include "StackedDGenerator.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace multi_acs {
+
+Planner::Planner(MultiACSParameters* params, CollectionInfo &collection) :
+	params(params),
+	m(collection.getSequenceNumber()),
+	n(collection.size) {
+	if(params->all_vs_all) {
+		for(const pair<const SequenceNumber, SequenceLength> &color : collection.colors)
+			lengths.push_back(color.second);
+	}
+	else {
+		for(const SequenceNumber color : params->reference_colors) {
+			if(collection.colors.count(color) == 0) {
+				ostringstream err_message;
+				err_message << "Couldn't find reference color " << color << " in target collection";
+				Error::stopWithError(C_Planner_ClassName, __func__, err_message.str());
+			}
+			lengths.push_back(collection.colors[color]);
+		}
+	}
+	for(const SequenceLength n_x : lengths) {
+		longest = max(longest, n_x);
+		total_length += n_x;
+	}
+}
+
+Planner::~Planner() {
+
+}
+
+// Stacks held together: one for each reference of a scan when D is inline
+// (or generated by blocks in all-vs-all mode), one for each reference of the
+// preprocessing scan, times the workers when D is generated by chunks
+AllocableMemory Planner::dStacks() const {
+	const AllocableMemory stacks = params->inlineD() || params->all_vs_all ?
+			params->scanReferences(references(), m) : references();
+	return params->inlineD() ? stacks : stacks*StackedDGenerator::chunkWorkers(params, n);
+}
+
+// The intervals of a stack grow by doubling up to twice d_stack_memory,
+// and once spilled the bottom ones (up to half of those in memory) are
+// buffered from their stream
+AllocableMemory Planner::stackBytes() const {
+	const AllocableMemory interval = sizeof(stackedLCPInterval);
+	return 2*params->d_stack_memory + C_PlanStreamBytes
+			+ min((AllocableMemory) BUFFER_SIZE*interval, params->d_stack_memory/2 + interval);
+}
+
+/* The .d files are generated before the forward scans by the stacks and a
+ * writer for each reference of the pass. By chunks, each chunk has its
+ * stream of intervals and its snapshots, and the records of one chunk at a
+ * time are copied back; the GESA of the workers is read in place from its
+ * mapping.
+ */
+AllocableMemory Planner::dGenerationBytes() const {
+	if(params->inlineD())
+		return 0;
+	const AllocableMemory K = params->all_vs_all ? params->scanReferences(references(), m) : references();
+	const AllocableMemory T = StackedDGenerator::chunkWorkers(params, n);
+	AllocableMemory bytes = dStacks()*stackBytes() + K*(sizeof(LCPWriter) + C_PlanStreamBytes);
+	if(T > 1) {
+		// Snapshots reserved by each worker but the first one
+		const AllocableMemory snapshots = min(max(C_MaxDSnapshots, K), K*(n/T + 1));
+		bytes += K*T*C_PlanStreamBytes + (T - 1)*snapshots*sizeof(DStateSnapshot)
+				+ BUFFER_SIZE*sizeof(DPairRecord);
+	}
+	return bytes;
+}
+
+// As in backwardComputation and tiledBackwardComputation
+SequenceLength Planner::backwardPageRows(const SequenceLength n_x) const {
+	const SequenceLength Q = params->checkpoint_clcp || params->tiled_clcp
+			? params->forwardPageRows(references(), m) : params->backwardPageRows(m);
+	return Q > n_x ? n_x : Q;
+}
+
+AllocableMemory Planner::forwardArenaBytes() const {
+	if(params->all_vs_all)
+		return 0;
+	const SequenceLength Q = min(params->forwardPageRows(references(), m), longest);
+	// The chunks share the page rows, the rows crossing them are fixed by pages
+	if(params->chunkedForward()) {
+		const SequenceLength Q_t = Q/params->threads > 0 ? Q/params->threads : 1;
+		return params->threads*2*PageArena::mappedBytes(Q_t + 1, m) + PageArena::mappedBytes(Q, m);
+	}
+	// The page filled and the page drained by the writer thread; the
+	// checkpoints keep only the colors met
+	AllocableMemory bytes = 2*PageArena::mappedBytes(Q + 1, m)
+			+ (params->tiled_clcp ? PageArena::mappedBytes(Q, m) : 0);
+	if(params->checkpoint_clcp)
+		bytes = params->verbose ? PageArena::mappedBytes(Q + 1, m) : 0;
+	return params->scanReferences(references(), m)*bytes;
+}
+
+AllocableMemory Planner::backwardArenaBytes() const {
+	if(params->all_vs_all)
+		return 0;
+	const SequenceLength Q = backwardPageRows(longest);
+	// A recomputed page is held with the rows of the scanner recomputing it,
+	// a sparse page is rebuilt in place, the other ones are read ahead
+	if(params->checkpoint_clcp)
+		return PageArena::mappedBytes(Q + 1, m) + PageArena::mappedBytes(Q + 2, m);
+	if(params->sparse_clcp)
+		return PageArena::mappedBytes(Q + 1, m);
+	if(params->tiled_clcp)
+		return 2*PageArena::mappedBytes(Q, m);
+	return 2*PageArena::mappedBytes(Q + 1, m);
+}
+
+AllocableMemory Planner::heapBytes() const {
+	const AllocableMemory K = references();
+	const AllocableMemory B = params->scanReferences(K, m);
+	// score_r and score_x of every reference (score_r against every color in
+	// all-vs-all mode), and the score_x of the backward workers
+	AllocableMemory bytes = (params->all_vs_all ? (AllocableMemory) m*m : 2*K*m)*sizeof(LetterNumber)
+			+ (AllocableMemory) m*sizeof(LetterNumber);
+	bytes += (AllocableMemory) m*C_PlanColorBytes;
+	// Columns of a scan (id, lcp and the D of each of its references),
+	// streams of each reference (lcp_x, D, partial cLCP) and colors of each
+	// scanner, with the stacks of the inline D
+	AllocableMemory scan = (4 + B)*C_PlanSpanBytes + 3*B*C_PlanStreamBytes + 4*B*m*sizeof(LetterNumber);
+	if(params->inlineD())
+		scan += dStacks()*stackBytes();
+	return bytes + max(scan, dGenerationBytes());
+}
+
+AllocableMemory Planner::pageArenaBytes() const {
+	return max(forwardArenaBytes(), backwardArenaBytes());
+}
+
+LetterNumber Planner::targetScanBytes() const {
+	return n*(params->gesa_columns ? sizeof(t_GSA) : sizeof(SequenceNumber) + sizeof(SequenceLength));
+}
+
+LetterNumber Planner::clcpBytes(const SequenceLength n_x) const {
+	if(params->all_vs_all)
+		return 0;
+	const LetterNumber row = (LetterNumber) m*sizeof(SequenceLength);
+	if(params->checkpoint_clcp) {
+		const LetterNumber Q = min(params->forwardPageRows(references(), m), n_x);
+		const LetterNumber pages = (n_x + Q - 1)/Q;
+		return sizeof(SequenceLength) + pages*(sizeof(SequenceLength) + sizeof(LetterNumber) + row);
+	}
+	// At most a whole row for each row, with its offset in the index
+	if(params->sparse_clcp)
+		return (LetterNumber) n_x*(sizeof(SequenceNumber) + row + sizeof(LetterNumber)) + row;
+	return (LetterNumber) n_x*row;
+}
+
+// Working files of the run (.xclcp, .xckp, .d, .xlcp). Spilled D stacks
+// (.dstk) and the traces of -v are not counted
+LetterNumber Planner::scratchBytes() const {
+	LetterNumber bytes = 0;
+	for(const SequenceLength n_x : lengths)
+		bytes += clcpBytes(n_x);
+	// The .d files of all-vs-all mode are removed after each scan
+	if(!params->inlineD())
+		bytes += (params->all_vs_all ? params->scanReferences(references(), m) : references())
+				*n*sizeof(SequenceLength);
+	if(params->derive_lcp)
+		bytes += total_length*sizeof(SequenceLength);
+	return bytes;
+}
+
+LetterNumber Planner::readBytes() const {
+	const LetterNumber K = references();
+	const LetterNumber B = params->scanReferences(K, m);
+	const LetterNumber scan = targetScanBytes();
+	const LetterNumber d_bytes = n*sizeof(SequenceLength);
+	LetterNumber bytes = 0;
+	// Generation of the .d files, by one scan or one for each block
+	if(!params->inlineD())
+		bytes += (params->all_vs_all ? (K + B - 1)/B : 1)*scan;
+	// Forward scans, with one more scan for the inline D, or the .d files
+	bytes += ((K + B - 1)/B)*scan*(params->inlineD() ? 2 : 1);
+	if(!params->inlineD())
+		bytes += K*d_bytes;
+	// The LCP of each reference is derived by one more scan
+	if(params->derive_lcp || params->all_vs_all)
+		bytes += K*scan;
+	else
+		bytes += total_length*sizeof(SequenceLength);
+	// Backward passes, the checkpoints rescanning the target collection
+	if(!params->all_vs_all) {
+		for(const SequenceLength n_x : lengths)
+			bytes += clcpBytes(n_x) + (LetterNumber) n_x*sizeof(SequenceLength);
+		if(params->checkpoint_clcp)
+			bytes += K*(scan + d_bytes);
+	}
+	return bytes;
+}
+
+LetterNumber Planner::writeBytes() const {
+	LetterNumber bytes = 0;
+	if(!params->inlineD())
+		bytes += references()*n*sizeof(SequenceLength);
+	for(const SequenceLength n_x : lengths)
+		bytes += clcpBytes(n_x);
+	if(params->derive_lcp)
+		bytes += total_length*sizeof(SequenceLength);
+	return bytes;
+}
+
+/* The D stacks get at most a quarter of what the scores and the streams
+ * leave, as they grow to twice their memory (they spill beyond it), the
+ * pages what remains. The pages and the references of a scan shrink
+ * together, so -Q is lowered until the expected peak fits, by at least one
+ * row at a time.
+ */
+void Planner::fitMemory(const AllocableMemory budget) {
+	const AllocableMemory row = (AllocableMemory) m*sizeof(SequenceLength);
+	const AllocableMemory min_amount = 2*row;
+	params->memory_amount = max(budget, min_amount);
+	const AllocableMemory d_stack_memory = params->d_stack_memory;
+	params->d_stack_memory = 0;
+	const AllocableMemory fixed = heapBytes();
+	params->d_stack_memory = fixed < budget ?
+			min(d_stack_memory, (budget - fixed)/(8*dStacks())) : 0;
+	while(heapBytes() + pageArenaBytes() > budget && params->memory_amount > min_amount) {
+		const AllocableMemory excess = max(heapBytes() + pageArenaBytes() - budget, row);
+		params->memory_amount = params->memory_amount > min_amount + excess ?
+				params->memory_amount - excess : min_amount;
+	}
+	if(heapBytes() + pageArenaBytes() > budget) {
+		ostringstream err_message;
+		err_message << "RAM budget of " << budget << " bytes below the "
+				<< heapBytes() + pageArenaBytes() << " bytes of the smallest plan";
+		Error::stopWithError(C_Planner_ClassName, __func__, err_message.str());
+	}
+	// Every worker of a chunked forward computation needs a row of the page
+	const SequenceLength Q = params->forwardPageRows(references(), m);
+	if(params->chunkedForward() && Q < params->threads)
+		params->threads = Q;
+}
+
+bool Planner::fitScratch(const LetterNumber budget) {
+	if(scratchBytes() <= budget)
+		return false;
+	// The checkpoints of the partial cLCP take one row for each page
+	if(!params->all_vs_all && !params->sparse_clcp && !params->checkpoint_clcp && !params->tiled_clcp) {
+		params->checkpoint_clcp = true;
+		if(scratchBytes() <= budget)
+			return true;
+		params->checkpoint_clcp = false;
+	}
+	ostringstream err_message;
+	err_message << "Scratch budget of " << budget << " bytes below the "
+			<< scratchBytes() << " bytes of the working files";
+	Error::stopWithError(C_Planner_ClassName, __func__, err_message.str());
+	return false;
+}
+
+void Planner::printPlan() const {
+	const AllocableMemory heap = heapBytes();
+	const AllocableMemory arena = pageArenaBytes();
+	cout << "----- PLAN -----\n";
+	cout << "References: " << references() << ", "
+			<< params->scanReferences(references(), m) << " by scan\n";
+	cout << "Page memory (-Q): " << params->memory_amount << " bytes, "
+			<< params->forwardPageRows(references(), m) << " rows by forward page\n";
+	cout << "D interval stacks: " << dStacks() << " x " << params->d_stack_memory << " bytes\n";
+	cout << "Worker threads: " << params->threads << '\n';
+	cout << "Peak memory bound: " << heap + arena << " bytes (heap " << heap
+			<< ", page arena " << arena << ")\n";
+	cout << "Scratch disk: " << scratchBytes() << " bytes\n";
+	cout << "I/O volume: " << readBytes() << " bytes read, " << writeBytes() << " bytes written\n";
+	cout << "--- END PLAN ---" << endl;
+}
+
+} /* namespace multi_acs */
@@ -0,0 +1,106 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include "Parameters.h"
+#include "CollectionInfo.h"
+#include "Types.h"
+#include <vector>
+#include <cstdio>
+
+namespace multi_acs {
+
+const char C_Planner_ClassName[]{"Planner"};
+// Memory of a column read by spans (BUFFER_SIZE values gathered from the
+// records), of a buffered stream and of a color in the collection info
+const AllocableMemory C_PlanSpanBytes{BUFFER_SIZE*sizeof(SequenceLength)};
+const AllocableMemory C_PlanStreamBytes{BUFSIZ};
+const AllocableMemory C_PlanColorBytes{64};
+
+// Expected memory, scratch disk and I/O of a run, from the sizes of the
+// target collection and of the references. Given a RAM budget (--mem) it
+// shares it among the pages (-Q), the D interval stacks and the workers;
+// given a scratch budget (--scratch) it stores the partial cLCP as
+// checkpoints when .xclcp would not fit.
+class Planner {
+public:
+	Planner(MultiACSParameters* params, CollectionInfo &collection);
+	~Planner();
+
+	void fitMemory(const AllocableMemory budget);
+	// Returns whether the format of the partial cLCP was changed
+	bool fitScratch(const LetterNumber budget);
+	void printPlan() const;
+
+	// Expected sizes, in bytes
+	AllocableMemory heapBytes() const;
+	AllocableMemory pageArenaBytes() const;
+	LetterNumber scratchBytes() const;
+	LetterNumber readBytes() const;
+	LetterNumber writeBytes() const;
+
+private:
+	MultiACSParameters* params;
+	// Colors and size of the target collection
+	const SequenceNumber m;
+	const LetterNumber n;
+	// Lengths of the references of the run
+	std::vector<SequenceLength> lengths;
+	SequenceLength longest{0};
+	LetterNumber total_length{0};
+
+	SequenceNumber references() const { return lengths.size(); }
+	AllocableMemory dStacks() const;
+	AllocableMemory stackBytes() const;
+	AllocableMemory dGenerationBytes() const;
+	SequenceLength backwardPageRows(const SequenceLength n_x) const;
+	AllocableMemory forwardArenaBytes() const;
+	AllocableMemory backwardArenaBytes() const;
+	// Bytes of one scan of the id and lcp columns of the target collection
+	LetterNumber targetScanBytes() const;
+	// Bytes of the partial cLCP of a reference, as stored by the run
+	LetterNumber clcpBytes(const SequenceLength n_x) const;
+};
+
+} /* namespace multi_acs */
+
+#endif /* PLANNER_H_ */
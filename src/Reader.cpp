@@ -39,192 +39,258 @@
  ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **/
 #include "Reader.h"
+#include "Tools.h"
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace multi_acs {
 
-GESAReader::GESAReader(FILE* gesa_file) :
-	gesa_file(gesa_file) { }
-
-GESAReader::~GESAReader() {
-
-}
-
-bool GESAReader::readGESAStruct(t_GSA &gesa_struct) {
-	LetterNumber num_read = 0;
-	if(struct_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(t_GSA), BUFFER_SIZE, gesa_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
-		}
-		struct_counter = 0;
+MappedFile::MappedFile(FILE* file, const LetterNumber offset) {
+	struct stat file_stat;
+	if(fstat(fileno(file), &file_stat) != 0)
+		Error::stopWithError(C_Reader_ClassName, __func__, "Couldn't stat file");
+	if((LetterNumber) file_stat.st_size <= offset)
+		return;
+
+	// The mapping starts at a page boundary
+	const LetterNumber page_size = sysconf(_SC_PAGESIZE);
+	const LetterNumber map_offset = offset - offset%page_size;
+	map_length = file_stat.st_size - map_offset;
+	map_address = mmap(nullptr, map_length, PROT_READ, MAP_SHARED, fileno(file), map_offset);
+	if(map_address == MAP_FAILED) {
+		std::ostringstream err_message;
+		err_message << "Couldn't map file: " << strerror(errno);
+		Error::stopWithError(C_Reader_ClassName, __func__, err_message.str());
 	}
-	gesa_struct = buffer[struct_counter++];
-	return true;
+	madvise(map_address, map_length, MADV_SEQUENTIAL);
+	data = static_cast<const unsigned char*>(map_address) + (offset - map_offset);
+	size = file_stat.st_size - offset;
 }
 
+MappedFile::~MappedFile() {
+	if(map_address != nullptr)
+		munmap(map_address, map_length);
+}
 
-EBWTReader::EBWTReader(FILE* ebwt_file) :
-	ebwt_file(ebwt_file) { }
+DerivedLCPReader::DerivedLCPReader(FILE* id_file, FILE* lcp_file,
+		const ColumnFile &id_column, const ColumnFile &lcp_column, const LetterNumber first,
+		const SequenceNumber color, FILE* copy_file) :
+	id_reader(id_file, id_column, first),
+	lcp_reader(lcp_file, lcp_column, first),
+	color(color),
+	copy_file(copy_file),
+	copy_writer(copy_file) { }
 
-EBWTReader::~EBWTReader() {
+DerivedLCPReader::~DerivedLCPReader() {
 
 }
 
-bool EBWTReader::readEBWTSymbol(AlphabetSymbol& symbol) {
-	LetterNumber num_read = 0;
-	if(symbol_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(AlphabetSymbol), BUFFER_SIZE, ebwt_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
+bool DerivedLCPReader::readLCPValue(SequenceLength& value) {
+	SequenceNumber id;
+	SequenceLength lcp;
+	SequenceLength min_lcp = C_MaxSequenceLength;
+	while(id_reader.readSequenceId(id) && lcp_reader.readLCPValue(lcp)) {
+		if(lcp < min_lcp)
+			min_lcp = lcp;
+		if(id == color) {
+			value = min_lcp;
+			if(copy_file != nullptr)
+				copy_writer.writeLCPValue(value);
+			return true;
 		}
-		symbol_counter = 0;
 	}
-	symbol = buffer[symbol_counter++];
-	return true;
+	return false;
+}
+
+void DerivedLCPReader::flushCopy() {
+	if(copy_file != nullptr)
+		copy_writer.flushLCPValues();
 }
 
-IdReader::IdReader(FILE* id_file) :
-	id_file(id_file) { }
+IrrReader::IrrReader(FILE* irr_file, const LetterNumber irr_file_size) :
+	irr_file(irr_file),
+	irr_file_size(irr_file_size){ }
 
-IdReader::~IdReader() {
+IrrReader::~IrrReader() {
 
 }
 
-bool IdReader::readSequenceId(SequenceNumber& id) {
+bool IrrReader::readIrrilevantBit(bool &irrilevant_bit) {
 	LetterNumber num_read = 0;
-	if(id_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(SequenceNumber), BUFFER_SIZE, id_file);
+	if(bit_counter == last_num_read) {
+		num_read = fread(buffer, sizeof(BitGroup), BUFFER_SIZE, irr_file);
 		if(num_read == 0) {
 			return false;
 		} else {
-			last_num_read = num_read;
+			last_num_read = num_read*8;
 		}
-		id_counter = 0;
+		bit_counter = 0;
 	}
-	id = buffer[id_counter++];
-	return true;
+	if(global_bit_counter < irr_file_size) {
+		int byte_pos = bit_counter/(8*sizeof(BitGroup));
+		int shift_in_byte = bit_counter%(8*sizeof(BitGroup));
+		irrilevant_bit = buffer[byte_pos] & (1 << shift_in_byte);
+		++bit_counter;
+		++global_bit_counter;
+		return true;
+	}
+	return false;
 }
 
-LCPReader::LCPReader(FILE* lcp_file) :
-	lcp_file(lcp_file) { }
+SparseCLCPReader::SparseCLCPReader(FILE* clcp_file, FILE* index_file,
+		SequenceNumber seq_num, SequenceLength rows_num) :
+	clcp_file(clcp_file),
+	seq_num(seq_num),
+	rows_num(rows_num),
+	block_offsets((rows_num + C_SparseCLCPBlockRows - 1)/C_SparseCLCPBlockRows + 1, 0),
+	row(seq_num, 0),
+	rows_counter(rows_num) {
+
+	const LetterNumber blocks_num = block_offsets.size() - 1;
+	if(fread(block_offsets.data(), sizeof(LetterNumber), blocks_num, index_file) != blocks_num ||
+			fread(row.data(), sizeof(SequenceLength), seq_num, index_file) != seq_num) {
+		std::ostringstream err_message;
+		err_message << "Incomplete sparse cLCP index";
+		Error::stopWithError(C_Reader_ClassName, __func__, err_message.str());
+	}
+	fseeko(clcp_file, 0, SEEK_END);
+	block_offsets[blocks_num] = ftello(clcp_file);
+}
 
-LCPReader::~LCPReader() {
+SparseCLCPReader::~SparseCLCPReader() {
 
 }
 
-bool LCPReader::readLCPValue(SequenceLength& value) {
-	LetterNumber num_read = 0;
-	if(lcp_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(SequenceLength), BUFFER_SIZE, lcp_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
-		}
-		lcp_counter = 0;
-	}
-	value = buffer[lcp_counter++];
+bool SparseCLCPReader::readPreviousCLCPRow(SequenceLength *clcp_row) {
+	if(rows_counter == 0)
+		return false;
+	// The last row is stored in the index, any other row is obtained by
+	// undoing the changes of the following one
+	if(rows_counter < rows_num)
+		undoRow(rows_counter);
+	--rows_counter;
+	std::copy(row.begin(), row.end(), clcp_row);
 	return true;
 }
 
-DReader::DReader(FILE* d_file) :
-	d_file(d_file) { }
-
-DReader::~DReader() {
+void SparseCLCPReader::undoRow(const LetterNumber h) {
 
-}
-
-bool DReader::readDValue(SequenceLength& value) {
-	LetterNumber num_read = 0;
-	if(d_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(SequenceLength), BUFFER_SIZE, d_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
+	const LetterNumber b = h/C_SparseCLCPBlockRows;
+	if(b != loaded_block) {
+		block.resize(block_offsets[b + 1] - block_offsets[b]);
+		fseeko(clcp_file, (off_t) block_offsets[b], SEEK_SET);
+		if(fread(block.data(), 1, block.size(), clcp_file) != block.size()) {
+			std::ostringstream err_message;
+			err_message << "Incomplete sparse cLCP block " << b;
+			Error::stopWithError(C_Reader_ClassName, __func__, err_message.str());
+		}
+		row_offsets.clear();
+		for(LetterNumber offset = 0; offset < block.size(); ) {
+			SequenceNumber deltas_num;
+			memcpy(&deltas_num, &block[offset], sizeof(SequenceNumber));
+			row_offsets.push_back(offset);
+			offset += sizeof(SequenceNumber);
+			if(deltas_num == C_MaxSequenceNumber)
+				offset += (LetterNumber) seq_num*sizeof(SequenceLength);
+			else
+				offset += (LetterNumber) deltas_num*sizeof(CLCPDelta);
 		}
-		d_counter = 0;
+		loaded_block = b;
 	}
-	value = buffer[d_counter++];
-	return true;
-}
 
-ZReader::ZReader(FILE* z_file) :
-	z_file(z_file) { }
+	const LetterNumber offset = row_offsets[h - b*C_SparseCLCPBlockRows];
+	SequenceNumber deltas_num;
+	memcpy(&deltas_num, &block[offset], sizeof(SequenceNumber));
+	const unsigned char* deltas = &block[offset + sizeof(SequenceNumber)];
+	if(deltas_num == C_MaxSequenceNumber) {
+		memcpy(row.data(), deltas, (LetterNumber) seq_num*sizeof(SequenceLength));
+		return;
+	}
+	for(SequenceNumber i = 0; i < deltas_num; ++i) {
+		CLCPDelta delta;
+		memcpy(&delta, deltas + (LetterNumber) i*sizeof(CLCPDelta), sizeof(CLCPDelta));
+		row[delta.color] = delta.value;
+	}
+}
 
-ZReader::~ZReader() {
+CLCPCheckpointReader::CLCPCheckpointReader(FILE* checkpoint_file, SequenceNumber seq_num) :
+		checkpoint_file(checkpoint_file),
+		seq_num(seq_num) {
 
+	if(fread(&page_rows, sizeof(SequenceLength), 1, checkpoint_file) != 1 || page_rows == 0)
+		Error::stopWithError(C_Reader_ClassName, __func__, "Invalid cLCP checkpoint file");
 }
 
-bool ZReader::readZColor(SequenceNumber& color) {
-	LetterNumber num_read = 0;
-	if(color_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(SequenceNumber), BUFFER_SIZE, z_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
-		}
-		color_counter = 0;
-	}
-	color = buffer[color_counter++];
-	return true;
+CLCPCheckpointReader::~CLCPCheckpointReader() {
+
 }
 
-BReader::BReader(FILE* b_file) :
-	b_file(b_file) { }
+bool CLCPCheckpointReader::readCheckpoint(LetterNumber page, SequenceLength &h, LetterNumber &position, SequenceLength *clcp_row) {
+	const LetterNumber checkpoint_size = sizeof(SequenceLength) + sizeof(LetterNumber)
+			+ (LetterNumber) seq_num*sizeof(SequenceLength);
+	fseeko(checkpoint_file, (off_t) (sizeof(SequenceLength) + (page - 1)*checkpoint_size), SEEK_SET);
+	return fread(&h, sizeof(SequenceLength), 1, checkpoint_file) == 1
+			&& fread(&position, sizeof(LetterNumber), 1, checkpoint_file) == 1
+			&& fread(clcp_row, sizeof(SequenceLength), seq_num, checkpoint_file) == seq_num;
+}
 
-BReader::~BReader() {
+CLCPPageReader::CLCPPageReader(FILE* clcp_file, SequenceNumber seq_num, SequenceLength rows) :
+	clcp_fd(fileno(clcp_file)),
+	seq_num(seq_num),
+	page_rows(rows) {
+	pages[0].allocate(rows, seq_num);
+	pages[1].allocate(rows, seq_num);
+}
 
+CLCPPageReader::~CLCPPageReader() {
+	if(loader.joinable())
+		loader.join();
 }
 
-bool BReader::readBlock(Block& block) {
-	LetterNumber num_read = 0;
-	if(block_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(Block), BUFFER_SIZE, b_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read;
-		}
-		block_counter = 0;
+void CLCPPageReader::prefetch(const SequenceLength q, const SequenceLength rows_num) {
+	if(loader.joinable())
+		loader.join();
+	PageArena &page = pages[1 - current];
+	if(page.size() > (LetterNumber) page_rows*seq_num) {
+		page.release();
+		page.allocate(page_rows, seq_num);
 	}
-	block = buffer[block_counter++];
-	return true;
+	loader = std::thread(&CLCPPageReader::readPage, this, &pages[1 - current],
+			(LetterNumber) q*seq_num*sizeof(SequenceLength),
+			(LetterNumber) rows_num*seq_num*sizeof(SequenceLength));
 }
 
-IrrReader::IrrReader(FILE* irr_file, const LetterNumber irr_file_size) :
-	irr_file(irr_file),
-	irr_file_size(irr_file_size){ }
-
-IrrReader::~IrrReader() {
+void CLCPPageReader::shrink(const SequenceLength rows) {
+	page_rows = rows;
+}
 
+PageArena& CLCPPageReader::nextPage() {
+	if(loader.joinable())
+		loader.join();
+	if(!load_error.empty())
+		Error::stopWithError(C_Reader_ClassName, __func__, load_error);
+	current = 1 - current;
+	return pages[current];
 }
 
-bool IrrReader::readIrrilevantBit(bool &irrilevant_bit) {
-	LetterNumber num_read = 0;
-	if(bit_counter == last_num_read) {
-		num_read = fread(buffer, sizeof(BitGroup), BUFFER_SIZE, irr_file);
-		if(num_read == 0) {
-			return false;
-		} else {
-			last_num_read = num_read*8;
+void CLCPPageReader::readPage(PageArena* page, const LetterNumber offset, const LetterNumber length) {
+	unsigned char* data = reinterpret_cast<unsigned char*>(page->data());
+	for(LetterNumber done = 0; done < length; ) {
+		const ssize_t num_read = pread(clcp_fd, data + done, length - done, offset + done);
+		if(num_read <= 0) {
+			std::ostringstream err_message;
+			err_message << "Couldn't read cLCP page at offset " << offset + done
+					<< (num_read < 0 ? std::string(": ") + strerror(errno) : std::string(": end of file"));
+			load_error = err_message.str();
+			return;
 		}
-		bit_counter = 0;
-	}
-	if(global_bit_counter < irr_file_size) {
-		int byte_pos = bit_counter/(8*sizeof(BitGroup));
-		int shift_in_byte = bit_counter%(8*sizeof(BitGroup));
-		irrilevant_bit = buffer[byte_pos] & (1 << shift_in_byte);
-		++bit_counter;
-		++global_bit_counter;
-		return true;
+		done += num_read;
 	}
-	return false;
 }
 
 } /* namespace multi_acs */
@@ -42,98 +42,208 @@
 #define READER_H_
 
 #include "Types.h"
+#include "Writer.h"
+#include "PageArena.h"
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
 
 namespace multi_acs {
 
-class GESAReader {
-public:
-	GESAReader(FILE* gesa_file);
-	~GESAReader();
-	bool readGESAStruct(t_GSA &gesa_struct);
+const char C_Reader_ClassName[]{"Reader"};
 
-private:
-	FILE* gesa_file{nullptr};
-	t_GSA buffer[BUFFER_SIZE];
-	LetterNumber struct_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+// Column of a file of fixed size records: a field of the t_GSA records of a
+// .gesa file, or an extracted column (.id, .lcp) holding the values alone
+struct ColumnFile {
+	std::string file_name;
+	LetterNumber record_size;
+	LetterNumber field_offset;
+	LetterNumber field_size;
 };
 
-class EBWTReader {
+// Read-only mapping of a file, from offset to its end
+class MappedFile {
 public:
-	EBWTReader(FILE* ebwt_file);
-	~EBWTReader();
-	bool readEBWTSymbol(AlphabetSymbol &symbol);
+	MappedFile(FILE* file, const LetterNumber offset);
+	~MappedFile();
+
+protected:
+	const unsigned char* data{nullptr};
+	LetterNumber size{0};
 
 private:
-	FILE* ebwt_file{nullptr};
-	AlphabetSymbol buffer[BUFFER_SIZE]{'\0'};
-	LetterNumber symbol_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+	void* map_address{nullptr};
+	LetterNumber map_length{0};
 };
 
-class IdReader {
+// Column of elements of type T, starting from the first-th record of the
+// file and read in place from the mapping, one element at a time or by
+// spans. The elements of a contiguous column (record_size == sizeof(T))
+// are not copied, those of a field of larger records are gathered.
+// A field of field_size bytes other than sizeof(T) (a 32-bit field of the
+// .gesa read by a build with 16 or 64-bit types) is converted.
+template<typename T>
+class ColumnCursor : public MappedFile {
 public:
-	IdReader(FILE* id_file);
-	~IdReader();
-	bool readSequenceId(SequenceNumber &id);
+	ColumnCursor(FILE* file,
+			const LetterNumber first = 0,
+			const LetterNumber record_size = sizeof(T),
+			const LetterNumber field_offset = 0,
+			const LetterNumber field_size = sizeof(T)) :
+		MappedFile(file, first*record_size),
+		field(data + field_offset),
+		record_size(record_size),
+		field_size(field_size),
+		length(size/record_size) { }
+
+	bool next(T &value) {
+		if(position == length)
+			return false;
+		value = fieldValue(field + position*record_size);
+		++position;
+		return true;
+	}
+	// Up to max_length elements following the last one read: returns how
+	// many, 0 at the end of the column. A gathered span is valid up to the
+	// following call.
+	LetterNumber nextSpan(const T* &span, const LetterNumber max_length) {
+		const LetterNumber span_length = std::min(max_length, length - position);
+		if(record_size == sizeof(T) && field_size == sizeof(T)) {
+			span = reinterpret_cast<const T*>(field) + position;
+		}
+		else {
+			if(gathered.size() < span_length)
+				gathered.resize(span_length);
+			const unsigned char* record = field + position*record_size;
+			if(field_size == sizeof(T)) {
+				for(LetterNumber i = 0; i < span_length; ++i, record += record_size)
+					memcpy(&gathered[i], record, sizeof(T));
+			}
+			else {
+				for(LetterNumber i = 0; i < span_length; ++i, record += record_size)
+					gathered[i] = fieldValue(record);
+			}
+			span = gathered.data();
+		}
+		position += span_length;
+		return span_length;
+	}
+	// i-th element of the column, regardless of the elements read
+	T at(const LetterNumber i) const {
+		return fieldValue(field + i*record_size);
+	}
+	LetterNumber getLength() const { return length; }
+	LetterNumber remaining() const { return length - position; }
 
 private:
-	FILE* id_file{nullptr};
-	SequenceNumber buffer[BUFFER_SIZE]{0};
-	LetterNumber id_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+	const unsigned char* field{nullptr};
+	const LetterNumber record_size;
+	const LetterNumber field_size;
+	const LetterNumber length{0};
+	LetterNumber position{0};
+	std::vector<T> gathered;
+
+	T fieldValue(const unsigned char* record) const {
+		return fieldValue(record, typename std::is_integral<T>::type());
+	}
+	// Integer fields are little-endian unsigned integers
+	T fieldValue(const unsigned char* record, std::true_type) const {
+		if(field_size == sizeof(T)) {
+			T value;
+			memcpy(&value, record, sizeof(T));
+			return value;
+		}
+		uint64_t value = 0;
+		memcpy(&value, record, std::min(field_size, (LetterNumber) sizeof(uint64_t)));
+		return static_cast<T>(value);
+	}
+	T fieldValue(const unsigned char* record, std::false_type) const {
+		T value;
+		memcpy(&value, record, sizeof(T));
+		return value;
+	}
 };
 
-class LCPReader {
+class GESAReader : public ColumnCursor<t_GSA> {
 public:
-	LCPReader(FILE* lcp_file);
-	~LCPReader();
-	bool readLCPValue(SequenceLength &value);
+	GESAReader(FILE* gesa_file, const LetterNumber first = 0) :
+		ColumnCursor<t_GSA>(gesa_file, first) { }
+	bool readGESAStruct(t_GSA &gesa_struct) { return next(gesa_struct); }
+};
 
-private:
-	FILE* lcp_file{nullptr};
-	SequenceLength buffer[BUFFER_SIZE]{0};
-	LetterNumber lcp_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+class EBWTReader : public ColumnCursor<AlphabetSymbol> {
+public:
+	EBWTReader(FILE* ebwt_file) : ColumnCursor<AlphabetSymbol>(ebwt_file) { }
+	bool readEBWTSymbol(AlphabetSymbol &symbol) { return next(symbol); }
+};
+
+class IdReader : public ColumnCursor<SequenceNumber> {
+public:
+	IdReader(FILE* id_file, const LetterNumber first = 0) :
+		ColumnCursor<SequenceNumber>(id_file, first) { }
+	IdReader(FILE* id_file, const ColumnFile &column, const LetterNumber first = 0) :
+		ColumnCursor<SequenceNumber>(id_file, first, column.record_size, column.field_offset, column.field_size) { }
+	bool readSequenceId(SequenceNumber &id) { return next(id); }
 };
 
-class DReader {
+// Sequential source of LCP values
+class LCPSource {
 public:
-	DReader(FILE* d_file);
-	~DReader();
-	bool readDValue(SequenceLength &value);
+	virtual ~LCPSource() { }
+	virtual bool readLCPValue(SequenceLength &value) = 0;
+};
 
-private:
-	FILE* d_file{nullptr};
-	SequenceLength buffer[BUFFER_SIZE]{0};
-	LetterNumber d_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+class LCPReader : public LCPSource, public ColumnCursor<SequenceLength> {
+public:
+	LCPReader(FILE* lcp_file, const LetterNumber first = 0) :
+		ColumnCursor<SequenceLength>(lcp_file, first) { }
+	LCPReader(FILE* lcp_file, const ColumnFile &column, const LetterNumber first = 0) :
+		ColumnCursor<SequenceLength>(lcp_file, first, column.record_size, column.field_offset, column.field_size) { }
+	bool readLCPValue(SequenceLength &value) { return next(value); }
 };
 
-class ZReader {
+// LCP of a sequence of the collection, derived from the LCP and the
+// colors of the whole collection: the LCP of two consecutive suffixes of
+// the sequence is the minimum LCP between them in the collection.
+// The values read can be copied to copy_file.
+class DerivedLCPReader : public LCPSource {
 public:
-	ZReader(FILE* z_file);
-	~ZReader();
-	bool readZColor(SequenceNumber &color);
+	DerivedLCPReader(FILE* id_file, FILE* lcp_file,
+			const ColumnFile &id_column, const ColumnFile &lcp_column, const LetterNumber first,
+			const SequenceNumber color, FILE* copy_file = nullptr);
+	~DerivedLCPReader();
+	bool readLCPValue(SequenceLength &value);
+	void flushCopy();
 
 private:
-	FILE* z_file{nullptr};
-	SequenceNumber buffer[BUFFER_SIZE]{0};
-	LetterNumber color_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+	IdReader id_reader;
+	LCPReader lcp_reader;
+	const SequenceNumber color;
+	FILE* copy_file{nullptr};
+	LCPWriter copy_writer;
 };
 
-class BReader {
+class DReader : public ColumnCursor<SequenceLength> {
 public:
-	BReader(FILE* b_file);
-	~BReader();
-	bool readBlock(Block &block);
+	DReader(FILE* d_file, const LetterNumber first = 0) :
+		ColumnCursor<SequenceLength>(d_file, first) { }
+	bool readDValue(SequenceLength &value) { return next(value); }
+};
 
-private:
-	FILE* b_file{nullptr};
-	Block buffer[BUFFER_SIZE];
-	LetterNumber block_counter{BUFFER_SIZE};
-	LetterNumber last_num_read{BUFFER_SIZE};
+class ZReader : public ColumnCursor<SequenceNumber> {
+public:
+	ZReader(FILE* z_file) : ColumnCursor<SequenceNumber>(z_file) { }
+	bool readZColor(SequenceNumber &color) { return next(color); }
+};
+
+class BReader : public ColumnCursor<Block> {
+public:
+	BReader(FILE* b_file) : ColumnCursor<Block>(b_file) { }
+	bool readBlock(Block &block) { return next(block); }
 };
 
 class IrrReader {
@@ -151,6 +261,76 @@ private:
 	LetterNumber last_num_read{BUFFER_SIZE*(8*sizeof(BitGroup))};
 };
 
+// Rows of a partial cLCP written by SparseCLCPWriter, read from the last
+// to the first one
+class SparseCLCPReader {
+public:
+	SparseCLCPReader(FILE* clcp_file, FILE* index_file,
+			SequenceNumber seq_num, SequenceLength rows_num);
+	~SparseCLCPReader();
+	bool readPreviousCLCPRow(SequenceLength *clcp_row);
+
+private:
+	FILE* clcp_file{nullptr};
+	const SequenceNumber seq_num;
+	const LetterNumber rows_num;
+	std::vector<LetterNumber> block_offsets;
+	std::vector<SequenceLength> row;
+	// Rows not yet read
+	LetterNumber rows_counter{0};
+	// Changes of the rows of the loaded block, and where each row starts
+	std::vector<unsigned char> block;
+	std::vector<LetterNumber> row_offsets;
+	LetterNumber loaded_block{C_MaxLetterNumber};
+
+	void undoRow(const LetterNumber h);
+};
+
+// Checkpoints written by CLCPCheckpointWriter
+class CLCPCheckpointReader {
+public:
+	CLCPCheckpointReader(FILE* checkpoint_file, SequenceNumber seq_num);
+	~CLCPCheckpointReader();
+	SequenceLength getPageRows() const { return page_rows; }
+	// Checkpoint of the page-th page (page > 0)
+	bool readCheckpoint(LetterNumber page, SequenceLength &h, LetterNumber &position, SequenceLength *clcp_row);
+
+private:
+	FILE* checkpoint_file{nullptr};
+	const SequenceNumber seq_num;
+	SequenceLength page_rows{0};
+};
+
+// Pages of a partial cLCP read ahead by a loader thread, with one pread
+// each, into two arenas of rows rows: a page is read while the one before
+// is processed
+class CLCPPageReader {
+public:
+	CLCPPageReader(FILE* clcp_file, SequenceNumber seq_num, SequenceLength rows);
+	~CLCPPageReader();
+	// Start reading rows_num rows from row q into the arena not in use
+	void prefetch(const SequenceLength q, const SequenceLength rows_num);
+	// Wait for the page of the last prefetch, which becomes the current one
+	PageArena& nextPage();
+	// The page before the current one, until the next prefetch
+	PageArena& previousPage() { return pages[1 - current]; }
+	// Pages of rows rows from the next prefetch on: each arena is mapped
+	// again when it is next read into
+	void shrink(const SequenceLength rows);
+
+private:
+	const int clcp_fd;
+	const SequenceNumber seq_num;
+	PageArena pages[2];
+	SequenceLength page_rows;
+	unsigned int current{1};
+	std::thread loader;
+	// Error of the loader thread, raised by nextPage
+	std::string load_error;
+
+	void readPage(PageArena* page, const LetterNumber offset, const LetterNumber length);
+};
+
 } /* namespace multi_acs */
 
 #endif /* READER_H_ */
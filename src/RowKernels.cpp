@@ -0,0 +1,448 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "RowKernels.h"
+#include <immintrin.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+namespace multi_acs {
+
+// Scalar kernels, also used for the tails of the vector ones
+
+static void maxMinRowScalar(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	for(SequenceNumber r = 0; r < m; ++r)
+		dst[r] = max(min(a[r], bound), b[r]);
+}
+
+static void maxMinRowScoreScalar(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	for(SequenceNumber r = 0; r < m; ++r) {
+		dst[r] = max(min(a[r], bound), b[r]);
+		score[r] += dst[r];
+	}
+}
+
+static void addRowScalar(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	for(SequenceNumber r = 0; r < m; ++r)
+		score[r] += row[r];
+}
+
+static void addScoresScalar(LetterNumber score[], const LetterNumber other[], const SequenceNumber m) {
+	for(SequenceNumber r = 0; r < m; ++r)
+		score[r] += other[r];
+}
+
+// Vector kernels of 32 or 16-bit rows (64-bit rows use the scalar ones)
+
+#if MULTI_ACS_LCP_BITS == 32
+
+// SSE4.2: 4 values of a row, 2 scores
+
+__attribute__((target("sse4.2")))
+static void maxMinRowSSE(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m128i v_bound = _mm_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 4 <= m; r += 4) {
+		__m128i v = _mm_min_epu32(_mm_loadu_si128((const __m128i*) (a + r)), v_bound);
+		v = _mm_max_epu32(v, _mm_loadu_si128((const __m128i*) (b + r)));
+		_mm_storeu_si128((__m128i*) (dst + r), v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("sse4.2")))
+static void maxMinRowScoreSSE(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m128i v_bound = _mm_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 4 <= m; r += 4) {
+		__m128i v = _mm_min_epu32(_mm_loadu_si128((const __m128i*) (a + r)), v_bound);
+		v = _mm_max_epu32(v, _mm_loadu_si128((const __m128i*) (b + r)));
+		_mm_storeu_si128((__m128i*) (dst + r), v);
+		__m128i* s = (__m128i*) (score + r);
+		_mm_storeu_si128(s, _mm_add_epi64(_mm_loadu_si128(s), _mm_cvtepu32_epi64(v)));
+		_mm_storeu_si128(s + 1, _mm_add_epi64(_mm_loadu_si128(s + 1),
+				_mm_cvtepu32_epi64(_mm_srli_si128(v, 8))));
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("sse4.2")))
+static void addRowSSE(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 4 <= m; r += 4) {
+		const __m128i v = _mm_loadu_si128((const __m128i*) (row + r));
+		__m128i* s = (__m128i*) (score + r);
+		_mm_storeu_si128(s, _mm_add_epi64(_mm_loadu_si128(s), _mm_cvtepu32_epi64(v)));
+		_mm_storeu_si128(s + 1, _mm_add_epi64(_mm_loadu_si128(s + 1),
+				_mm_cvtepu32_epi64(_mm_srli_si128(v, 8))));
+	}
+	addRowScalar(score + r, row + r, m - r);
+}
+
+// AVX2: 8 values of a row, 4 scores
+
+__attribute__((target("avx2")))
+static void maxMinRowAVX2(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m256i v_bound = _mm256_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8) {
+		__m256i v = _mm256_min_epu32(_mm256_loadu_si256((const __m256i*) (a + r)), v_bound);
+		v = _mm256_max_epu32(v, _mm256_loadu_si256((const __m256i*) (b + r)));
+		_mm256_storeu_si256((__m256i*) (dst + r), v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("avx2")))
+static void maxMinRowScoreAVX2(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m256i v_bound = _mm256_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8) {
+		__m256i v = _mm256_min_epu32(_mm256_loadu_si256((const __m256i*) (a + r)), v_bound);
+		v = _mm256_max_epu32(v, _mm256_loadu_si256((const __m256i*) (b + r)));
+		_mm256_storeu_si256((__m256i*) (dst + r), v);
+		__m256i* s = (__m256i*) (score + r);
+		_mm256_storeu_si256(s, _mm256_add_epi64(_mm256_loadu_si256(s),
+				_mm256_cvtepu32_epi64(_mm256_castsi256_si128(v))));
+		_mm256_storeu_si256(s + 1, _mm256_add_epi64(_mm256_loadu_si256(s + 1),
+				_mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1))));
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("avx2")))
+static void addRowAVX2(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8) {
+		const __m256i v = _mm256_loadu_si256((const __m256i*) (row + r));
+		__m256i* s = (__m256i*) (score + r);
+		_mm256_storeu_si256(s, _mm256_add_epi64(_mm256_loadu_si256(s),
+				_mm256_cvtepu32_epi64(_mm256_castsi256_si128(v))));
+		_mm256_storeu_si256(s + 1, _mm256_add_epi64(_mm256_loadu_si256(s + 1),
+				_mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1))));
+	}
+	addRowScalar(score + r, row + r, m - r);
+}
+
+// AVX-512: 16 values of a row, 8 scores
+
+__attribute__((target("avx512f")))
+static void maxMinRowAVX512(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m512i v_bound = _mm512_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16) {
+		__m512i v = _mm512_min_epu32(_mm512_loadu_si512(a + r), v_bound);
+		v = _mm512_max_epu32(v, _mm512_loadu_si512(b + r));
+		_mm512_storeu_si512(dst + r, v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("avx512f")))
+static void maxMinRowScoreAVX512(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m512i v_bound = _mm512_set1_epi32(bound);
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16) {
+		__m512i v = _mm512_min_epu32(_mm512_loadu_si512(a + r), v_bound);
+		v = _mm512_max_epu32(v, _mm512_loadu_si512(b + r));
+		_mm512_storeu_si512(dst + r, v);
+		_mm512_storeu_si512(score + r, _mm512_add_epi64(_mm512_loadu_si512(score + r),
+				_mm512_cvtepu32_epi64(_mm512_castsi512_si256(v))));
+		_mm512_storeu_si512(score + r + 8, _mm512_add_epi64(_mm512_loadu_si512(score + r + 8),
+				_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 1))));
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("avx512f")))
+static void addRowAVX512(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16) {
+		const __m512i v = _mm512_loadu_si512(row + r);
+		_mm512_storeu_si512(score + r, _mm512_add_epi64(_mm512_loadu_si512(score + r),
+				_mm512_cvtepu32_epi64(_mm512_castsi512_si256(v))));
+		_mm512_storeu_si512(score + r + 8, _mm512_add_epi64(_mm512_loadu_si512(score + r + 8),
+				_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 1))));
+	}
+	addRowScalar(score + r, row + r, m - r);
+}
+
+#elif MULTI_ACS_LCP_BITS == 16
+
+// SSE4.2: 8 values of a row, 2 scores
+
+// score[i] += v[i] for the 8 values of v
+__attribute__((target("sse4.2")))
+static inline void addLanesSSE(LetterNumber score[], const __m128i v) {
+	__m128i* s = (__m128i*) score;
+	_mm_storeu_si128(s, _mm_add_epi64(_mm_loadu_si128(s), _mm_cvtepu16_epi64(v)));
+	_mm_storeu_si128(s + 1, _mm_add_epi64(_mm_loadu_si128(s + 1), _mm_cvtepu16_epi64(_mm_srli_si128(v, 4))));
+	_mm_storeu_si128(s + 2, _mm_add_epi64(_mm_loadu_si128(s + 2), _mm_cvtepu16_epi64(_mm_srli_si128(v, 8))));
+	_mm_storeu_si128(s + 3, _mm_add_epi64(_mm_loadu_si128(s + 3), _mm_cvtepu16_epi64(_mm_srli_si128(v, 12))));
+}
+
+__attribute__((target("sse4.2")))
+static void maxMinRowSSE(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m128i v_bound = _mm_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8) {
+		__m128i v = _mm_min_epu16(_mm_loadu_si128((const __m128i*) (a + r)), v_bound);
+		v = _mm_max_epu16(v, _mm_loadu_si128((const __m128i*) (b + r)));
+		_mm_storeu_si128((__m128i*) (dst + r), v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("sse4.2")))
+static void maxMinRowScoreSSE(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m128i v_bound = _mm_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8) {
+		__m128i v = _mm_min_epu16(_mm_loadu_si128((const __m128i*) (a + r)), v_bound);
+		v = _mm_max_epu16(v, _mm_loadu_si128((const __m128i*) (b + r)));
+		_mm_storeu_si128((__m128i*) (dst + r), v);
+		addLanesSSE(score + r, v);
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("sse4.2")))
+static void addRowSSE(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8)
+		addLanesSSE(score + r, _mm_loadu_si128((const __m128i*) (row + r)));
+	addRowScalar(score + r, row + r, m - r);
+}
+
+// AVX2: 16 values of a row, 4 scores
+
+// score[i] += v[i] for the 16 values of v
+__attribute__((target("avx2")))
+static inline void addLanesAVX2(LetterNumber score[], const __m256i v) {
+	const __m128i low = _mm256_castsi256_si128(v);
+	const __m128i high = _mm256_extracti128_si256(v, 1);
+	__m256i* s = (__m256i*) score;
+	_mm256_storeu_si256(s, _mm256_add_epi64(_mm256_loadu_si256(s), _mm256_cvtepu16_epi64(low)));
+	_mm256_storeu_si256(s + 1, _mm256_add_epi64(_mm256_loadu_si256(s + 1), _mm256_cvtepu16_epi64(_mm_srli_si128(low, 8))));
+	_mm256_storeu_si256(s + 2, _mm256_add_epi64(_mm256_loadu_si256(s + 2), _mm256_cvtepu16_epi64(high)));
+	_mm256_storeu_si256(s + 3, _mm256_add_epi64(_mm256_loadu_si256(s + 3), _mm256_cvtepu16_epi64(_mm_srli_si128(high, 8))));
+}
+
+__attribute__((target("avx2")))
+static void maxMinRowAVX2(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m256i v_bound = _mm256_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16) {
+		__m256i v = _mm256_min_epu16(_mm256_loadu_si256((const __m256i*) (a + r)), v_bound);
+		v = _mm256_max_epu16(v, _mm256_loadu_si256((const __m256i*) (b + r)));
+		_mm256_storeu_si256((__m256i*) (dst + r), v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("avx2")))
+static void maxMinRowScoreAVX2(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m256i v_bound = _mm256_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16) {
+		__m256i v = _mm256_min_epu16(_mm256_loadu_si256((const __m256i*) (a + r)), v_bound);
+		v = _mm256_max_epu16(v, _mm256_loadu_si256((const __m256i*) (b + r)));
+		_mm256_storeu_si256((__m256i*) (dst + r), v);
+		addLanesAVX2(score + r, v);
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("avx2")))
+static void addRowAVX2(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 16 <= m; r += 16)
+		addLanesAVX2(score + r, _mm256_loadu_si256((const __m256i*) (row + r)));
+	addRowScalar(score + r, row + r, m - r);
+}
+
+// AVX-512 (BW): 32 values of a row, 8 scores
+
+// score[i] += v[i] for the 32 values of v
+__attribute__((target("avx512f,avx512bw")))
+static inline void addLanesAVX512(LetterNumber score[], const __m512i v) {
+	_mm512_storeu_si512(score, _mm512_add_epi64(_mm512_loadu_si512(score),
+			_mm512_cvtepu16_epi64(_mm512_extracti32x4_epi32(v, 0))));
+	_mm512_storeu_si512(score + 8, _mm512_add_epi64(_mm512_loadu_si512(score + 8),
+			_mm512_cvtepu16_epi64(_mm512_extracti32x4_epi32(v, 1))));
+	_mm512_storeu_si512(score + 16, _mm512_add_epi64(_mm512_loadu_si512(score + 16),
+			_mm512_cvtepu16_epi64(_mm512_extracti32x4_epi32(v, 2))));
+	_mm512_storeu_si512(score + 24, _mm512_add_epi64(_mm512_loadu_si512(score + 24),
+			_mm512_cvtepu16_epi64(_mm512_extracti32x4_epi32(v, 3))));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void maxMinRowAVX512(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	const __m512i v_bound = _mm512_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 32 <= m; r += 32) {
+		__m512i v = _mm512_min_epu16(_mm512_loadu_si512(a + r), v_bound);
+		v = _mm512_max_epu16(v, _mm512_loadu_si512(b + r));
+		_mm512_storeu_si512(dst + r, v);
+	}
+	maxMinRowScalar(dst + r, a + r, bound, b + r, m - r);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void maxMinRowScoreAVX512(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	const __m512i v_bound = _mm512_set1_epi16(bound);
+	SequenceNumber r = 0;
+	for(; r + 32 <= m; r += 32) {
+		__m512i v = _mm512_min_epu16(_mm512_loadu_si512(a + r), v_bound);
+		v = _mm512_max_epu16(v, _mm512_loadu_si512(b + r));
+		_mm512_storeu_si512(dst + r, v);
+		addLanesAVX512(score + r, v);
+	}
+	maxMinRowScoreScalar(dst + r, a + r, bound, b + r, score + r, m - r);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void addRowAVX512(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 32 <= m; r += 32)
+		addLanesAVX512(score + r, _mm512_loadu_si512(row + r));
+	addRowScalar(score + r, row + r, m - r);
+}
+
+#endif
+
+#if MULTI_ACS_LCP_BITS != 64
+
+// Scores, whatever the width of the rows
+
+__attribute__((target("sse4.2")))
+static void addScoresSSE(LetterNumber score[], const LetterNumber other[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 2 <= m; r += 2) {
+		__m128i* s = (__m128i*) (score + r);
+		_mm_storeu_si128(s, _mm_add_epi64(_mm_loadu_si128(s),
+				_mm_loadu_si128((const __m128i*) (other + r))));
+	}
+	addScoresScalar(score + r, other + r, m - r);
+}
+
+__attribute__((target("avx2")))
+static void addScoresAVX2(LetterNumber score[], const LetterNumber other[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 4 <= m; r += 4) {
+		__m256i* s = (__m256i*) (score + r);
+		_mm256_storeu_si256(s, _mm256_add_epi64(_mm256_loadu_si256(s),
+				_mm256_loadu_si256((const __m256i*) (other + r))));
+	}
+	addScoresScalar(score + r, other + r, m - r);
+}
+
+__attribute__((target("avx512f")))
+static void addScoresAVX512(LetterNumber score[], const LetterNumber other[], const SequenceNumber m) {
+	SequenceNumber r = 0;
+	for(; r + 8 <= m; r += 8)
+		_mm512_storeu_si512(score + r, _mm512_add_epi64(_mm512_loadu_si512(score + r),
+				_mm512_loadu_si512(other + r)));
+	addScoresScalar(score + r, other + r, m - r);
+}
+
+#endif
+
+static RowKernels selectRowKernels() {
+	__builtin_cpu_init();
+#if MULTI_ACS_LCP_BITS == 64
+	return {"scalar", maxMinRowScalar, maxMinRowScoreScalar, addRowScalar, addScoresScalar};
+#else
+	// The 16-bit kernels need AVX-512 BW
+	if(__builtin_cpu_supports("avx512f") && (MULTI_ACS_LCP_BITS == 32 || __builtin_cpu_supports("avx512bw")))
+		return {"AVX-512", maxMinRowAVX512, maxMinRowScoreAVX512, addRowAVX512, addScoresAVX512};
+	if(__builtin_cpu_supports("avx2"))
+		return {"AVX2", maxMinRowAVX2, maxMinRowScoreAVX2, addRowAVX2, addScoresAVX2};
+	if(__builtin_cpu_supports("sse4.2"))
+		return {"SSE4.2", maxMinRowSSE, maxMinRowScoreSSE, addRowSSE, addScoresSSE};
+	return {"scalar", maxMinRowScalar, maxMinRowScoreScalar, addRowScalar, addScoresScalar};
+#endif
+}
+
+const RowKernels& rowKernels() {
+	static const RowKernels kernels = selectRowKernels();
+	return kernels;
+}
+
+SequenceNumber colorTileWidth(const SequenceLength rows, const SequenceNumber m) {
+	const SequenceNumber line = C_CacheLineSize/sizeof(SequenceLength);
+	long cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if(cache_size <= 0)
+		cache_size = C_DefaultL2CacheSize;
+	LetterNumber width = (cache_size/2)/((LetterNumber) max(rows, (SequenceLength) 1)*sizeof(SequenceLength));
+	width = max(width - width % line, (LetterNumber) line);
+	return (SequenceNumber) min(width, (LetterNumber) max(m, (SequenceNumber) 1));
+}
+
+void zeroRows(SequenceLength row[], const LetterNumber length) {
+	if(length > 0)
+		memset(row, 0, length*sizeof(SequenceLength));
+}
+
+} /* namespace multi_acs */
@@ -0,0 +1,100 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#ifndef ROWKERNELS_H_
+#define ROWKERNELS_H_
+
+#include "Types.h"
+
+namespace multi_acs {
+
+const LetterNumber C_CacheLineSize{64};
+// Assumed when the L2 cache size is not reported
+const long C_DefaultL2CacheSize{256 << 10};
+
+// Kernels of the m-wide row updates of the cLCP passes. The variant for
+// the instruction set of the processor (scalar, SSE4.2, AVX2 or AVX-512)
+// is selected through cpuid at the first call.
+struct RowKernels {
+	const char* name;
+	// dst[r] = max(min(a[r], bound), b[r])
+	void (*maxMinRow)(SequenceLength dst[], const SequenceLength a[],
+			const SequenceLength bound, const SequenceLength b[], const SequenceNumber m);
+	// dst[r] = max(min(a[r], bound), b[r]) and score[r] += dst[r]
+	void (*maxMinRowScore)(SequenceLength dst[], const SequenceLength a[],
+			const SequenceLength bound, const SequenceLength b[],
+			LetterNumber score[], const SequenceNumber m);
+	// score[r] += row[r]
+	void (*addRow)(LetterNumber score[], const SequenceLength row[], const SequenceNumber m);
+	// score[r] += other[r]
+	void (*addScores)(LetterNumber score[], const LetterNumber other[], const SequenceNumber m);
+};
+
+const RowKernels& rowKernels();
+
+inline void maxMinRow(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[], const SequenceNumber m) {
+	rowKernels().maxMinRow(dst, a, bound, b, m);
+}
+
+inline void maxMinRowScore(SequenceLength dst[], const SequenceLength a[],
+		const SequenceLength bound, const SequenceLength b[],
+		LetterNumber score[], const SequenceNumber m) {
+	rowKernels().maxMinRowScore(dst, a, bound, b, score, m);
+}
+
+inline void addRow(LetterNumber score[], const SequenceLength row[], const SequenceNumber m) {
+	rowKernels().addRow(score, row, m);
+}
+
+inline void addScores(LetterNumber score[], const LetterNumber other[], const SequenceNumber m) {
+	rowKernels().addScores(score, other, m);
+}
+
+// Zeroes length values starting from row
+void zeroRows(SequenceLength row[], const LetterNumber length);
+
+// Width of a tile of colors, such that a tile of a page of the given rows
+// fits half of the L2 cache: a multiple of a cache line, up to m
+SequenceNumber colorTileWidth(const SequenceLength rows, const SequenceNumber m);
+
+} /* namespace multi_acs */
+
+#endif /* ROWKERNELS_H_ */
@@ -43,395 +43,546 @@
 #include "Tools.h"
 #include "Reader.h"
 #include "Writer.h"
+#include "MemoryGovernor.h"
 #include "malloc_count/malloc_count.h"
 #include <sstream>
-#include <list>
+#include <thread>
+#include <functional>
 
 using namespace std;
 
 namespace multi_acs {
 
-StackedDGenerator::StackedDGenerator(MultiACSParameters* params) :
-	params(params) { }
+IntervalStack::IntervalStack(const string &spill_file_name, const AllocableMemory memory) :
+	spill_file_name(spill_file_name),
+	max_intervals(max(memory/sizeof(stackedLCPInterval), (AllocableMemory) 2)) { }
 
-StackedDGenerator::~StackedDGenerator() {
-	// TODO Auto-generated destructor stub
+IntervalStack::~IntervalStack() {
+	if(spill_file != nullptr) {
+		fclose(spill_file);
+		remove(spill_file_name.c_str());
+	}
 }
 
-bool StackedDGenerator::mapColor(SequenceNumber id) {
-	return (id == params->reference_color);
+void IntervalStack::push_front(const stackedLCPInterval &lcp_interval) {
+	if(intervals.size() - bottom >= max_intervals)
+		spill();
+	intervals.push_back(lcp_interval);
 }
 
-void StackedDGenerator::generateDPairs() {
-
-	std::string input_file_name = params->target_collection_file_name + C_GESAExt;
-	FILE* f_ESA = fopen(input_file_name.c_str(), "rb");
-	if(f_ESA == nullptr) {
-		std::ostringstream err_message;
-		err_message << "Couldn't open file " << input_file_name;
-		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+void IntervalStack::pop_front() {
+	intervals.pop_back();
+	if(intervals.size() == bottom) {
+		intervals.clear();
+		bottom = 0;
+		if(disk_top > disk_bottom)
+			reload();
 	}
-//	std::cout << "Read from EGSA File: " << input_file_name << std::endl;
+}
 
-	std::string d_file_name = params->output_file_name + C_DynBlockFileExt;
-	FILE* d_file = fopen(d_file_name.c_str(), "wb");
-	if(d_file == nullptr) {
-		std::ostringstream err_message;
-		err_message << "Couldn't open file " << d_file_name;
-		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+void IntervalStack::pop_back() {
+	if(disk_top > disk_bottom) {
+		if(++disk_bottom == disk_top) {
+			disk_bottom = disk_top = 0;
+		}
+		else if(disk_bottom == buffer_end) {
+			const LetterNumber count = min(disk_top - disk_bottom, (LetterNumber) BUFFER_SIZE);
+			disk_buffer.resize(count);
+			readIntervals(disk_bottom, disk_buffer.data(), count);
+			buffer_first = disk_bottom;
+			buffer_end = disk_bottom + count;
+		}
+		return;
 	}
-//	std::cout << "Write to D File: " << d_file_name << std::endl;
-
-	list<stackedLCPInterval> stacked_list;
-	stackedLCPInterval lcp_interval;
-	t_GSA buffer[BUFFER_SIZE];
-	LetterNumber num_read = 0, k = 0;
-	SequenceLength top_lcp = 0, max_common_lcp = 0;
-	bool current_color, successive_color;
-
-	clock_t start = clock();
-	time_t start_wc = time(NULL);
-	double elapsed, elapsed_wc;
-
-	cout << "D Computation Starting\n";
-	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
-
-	if((num_read = fread(buffer, sizeof(buffer[0]), BUFFER_SIZE, f_ESA)) > 0) {
+	if(++bottom == intervals.size()) {
+		intervals.clear();
+		bottom = 0;
+	}
+}
 
-		while(buffer[k].lcp == 0) ++k;
+void IntervalStack::clear() {
+	intervals.clear();
+	bottom = 0;
+	disk_bottom = disk_top = 0;
+}
 
-		lcp_interval = {
-				k - 1,				// pos
-				buffer[k].lcp,		// lcp value
-		};
-		stacked_list.push_front(lcp_interval);
-		// cout << stacked_list.size() << endl;
-		top_lcp = buffer[k].lcp;
-		current_color = mapColor(buffer[k].text);
-		++k;
+// The lower half of the intervals in memory goes on top of the spilled ones
+void IntervalStack::spill() {
+	if(spill_file == nullptr) {
+		spill_file = fopen(spill_file_name.c_str(), "w+b");
+		if(spill_file == nullptr) {
+			ostringstream err_message;
+			err_message << "Couldn't open file " << spill_file_name;
+			Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+		}
+	}
+	const LetterNumber count = (intervals.size() - bottom)/2;
+	fseeko(spill_file, (off_t) disk_top*sizeof(stackedLCPInterval), SEEK_SET);
+	fwrite(intervals.data() + bottom, sizeof(stackedLCPInterval), count, spill_file);
+	if(disk_top == disk_bottom) {
+		// The bottom of the stack is the first spilled interval
+		disk_buffer.assign(intervals.begin() + bottom,
+				intervals.begin() + bottom + min(count, (LetterNumber) BUFFER_SIZE));
+		buffer_first = 0;
+		buffer_end = disk_buffer.size();
+	}
+	else {
+		buffer_end = min(buffer_end, disk_top);
+	}
+	disk_top += count;
+	intervals.erase(intervals.begin(), intervals.begin() + bottom + count);
+	bottom = 0;
+}
 
-		for(LetterNumber i = k; i < num_read; ++i, ++k) {
+// The upper half of the memory is refilled from the top of the spilled intervals
+void IntervalStack::reload() {
+	const LetterNumber count = min(disk_top - disk_bottom, max(max_intervals/2, (LetterNumber) 1));
+	intervals.resize(count);
+	disk_top -= count;
+	readIntervals(disk_top, intervals.data(), count);
+	if(disk_top == disk_bottom)
+		disk_bottom = disk_top = 0;
+	else
+		buffer_end = min(buffer_end, disk_top);
+}
 
-			successive_color = mapColor(buffer[i].text);
+void IntervalStack::readIntervals(const LetterNumber i, stackedLCPInterval* lcp_intervals, const LetterNumber count) {
+	fseeko(spill_file, (off_t) i*sizeof(stackedLCPInterval), SEEK_SET);
+	if(fread(lcp_intervals, sizeof(stackedLCPInterval), count, spill_file) != count) {
+		ostringstream err_message;
+		err_message << "Couldn't read the interval stack from " << spill_file_name;
+		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+	}
+}
 
-			if(buffer[i].lcp != 0) {
+StackedDGenerator::StackedDGenerator(MultiACSParameters* params) :
+	params(params),
+	reference_color(params->reference_color),
+	stacked_list(params->workingFileName(reference_color) + C_DStackSpillFileExt, params->d_stack_memory) { }
 
-				if(buffer[i].lcp > top_lcp) {
+StackedDGenerator::StackedDGenerator(MultiACSParameters* params, const SequenceNumber reference_color) :
+	params(params),
+	reference_color(reference_color),
+	stacked_list(params->workingFileName(reference_color) + C_DStackSpillFileExt, params->d_stack_memory) { }
 
-					lcp_interval = {
-							k - 1,				// pos
-							buffer[i].lcp,		// lcp value
-					};
-					stacked_list.push_front(lcp_interval);
-					// cout << stacked_list.size() << endl;
-					top_lcp = buffer[i].lcp;
-
-				} else if (buffer[i].lcp < top_lcp) {
-
-					LetterNumber ini_pos = i - 1;
-					while(!stacked_list.empty() && buffer[i].lcp < top_lcp) {
-						ini_pos = stacked_list.front().pos;
-						stacked_list.pop_front();
-						// cout << stacked_list.size() << endl;
-						if(!stacked_list.empty())
-							top_lcp = stacked_list.front().lcp;
-						else
-							top_lcp = 0;
-					}
-
-					if(buffer[i].lcp > max_common_lcp) {
-
-						if(buffer[i].lcp > top_lcp) {
-
-							lcp_interval = {
-									ini_pos,			// pos
-									buffer[i].lcp,	// lcp value
-							};
-							stacked_list.push_front(lcp_interval);
-							// cout << stacked_list.size() << endl;
-						}
-					}
-					else {
-						max_common_lcp = buffer[i].lcp;
-					}
-					top_lcp = buffer[i].lcp;
+StackedDGenerator::StackedDGenerator(MultiACSParameters* params, const SequenceNumber reference_color, const unsigned int chunk) :
+	params(params),
+	reference_color(reference_color),
+	stacked_list(params->workingFileName(reference_color) + "_" + to_string(chunk) + C_DStackSpillFileExt, params->d_stack_memory),
+	chunk_file_name(params->workingFileName(reference_color) + "_" + to_string(chunk) + C_DChunkFileExt) { }
 
-				}
+StackedDGenerator::~StackedDGenerator() {
+	if(chunk_file != nullptr) {
+		fclose(chunk_file);
+		remove(chunk_file_name.c_str());
+	}
+}
 
-				if(successive_color != current_color) {
-					while(!stacked_list.empty()) {
-						stackedLCPInterval wr_lcp_interval = stacked_list.back();
-						stacked_list.pop_back();
-						 cout << "D[" << wr_lcp_interval.pos <<
-								"] = " << wr_lcp_interval.lcp + 1 << endl;
-						 cout << stacked_list.size() << endl;
-						fwrite(&wr_lcp_interval, sizeof(lcp_interval), 1, d_file);
-						max_common_lcp = wr_lcp_interval.lcp;
-					}
-					current_color = successive_color;
-				}
+bool StackedDGenerator::mapColor(SequenceNumber id) {
+	return (id == reference_color);
+}
 
-			} else {
+void StackedDGenerator::generateD() {
 
-				while(!stacked_list.empty()) {
-					stacked_list.pop_front();
-					// cout << stacked_list.size() << endl;
-				}
-				current_color = successive_color;
-				max_common_lcp = 0;
-				top_lcp = 0;
+	std::string input_file_name = params->target_collection_file_name + C_GESAExt;
+	FILE* f_ESA = fopen(input_file_name.c_str(), "rb");
+	if(f_ESA == nullptr) {
+		std::ostringstream err_message;
+		err_message << "Couldn't open file " << input_file_name;
+		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+	}
+//	std::cout << "Read from EGSA File: " << input_file_name << std::endl;
+	GESAReader gesa_reader(f_ESA);
 
-			}
+	beginD();
 
+	const LetterNumber n = gesa_reader.getLength();
+	const unsigned int T = chunkWorkers(params, n);
+	if(T > 1) {
+		generateDChunks(f_ESA, n, T, vector<StackedDGenerator*>(1, this));
+	}
+	else {
+		const t_GSA* block;
+		LetterNumber block_length;
+		while((block_length = gesa_reader.nextSpan(block, BUFFER_SIZE)) > 0) {
+			for(LetterNumber b = 0; b < block_length; ++b)
+				processGESAStruct(block[b]);
+			MemoryGovernor::checkCeiling(C_StackedDGenerator_ClassName, __func__);
 		}
 	}
 
-	while ((num_read = fread(buffer, sizeof(buffer[0]), BUFFER_SIZE, f_ESA)) > 0)  {
+	endD();
 
-		for(LetterNumber i = 0; i < num_read; ++i, ++k) {
+	fclose(f_ESA);
+}
 
-			successive_color = mapColor(buffer[i].text);
+// The D files of several references are generated by one scan of the
+// target GESA, each with its own stack of intervals, or by one chunked
+// pass with several threads
+void StackedDGenerator::generateD(MultiACSParameters* params, const vector<SequenceNumber> &reference_colors) {
 
-			if(buffer[i].lcp != 0) {
+	std::string input_file_name = params->target_collection_file_name + C_GESAExt;
+	FILE* f_ESA = fopen(input_file_name.c_str(), "rb");
+	if(f_ESA == nullptr) {
+		std::ostringstream err_message;
+		err_message << "Couldn't open file " << input_file_name;
+		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+	}
+	GESAReader gesa_reader(f_ESA);
 
-				if(buffer[i].lcp > top_lcp) {
+	vector<unique_ptr<StackedDGenerator>> d_generators;
+	vector<StackedDGenerator*> chunked_generators;
+	for(const SequenceNumber color : reference_colors) {
+		d_generators.push_back(unique_ptr<StackedDGenerator>(new StackedDGenerator(params, color)));
+		d_generators.back()->beginD();
+		chunked_generators.push_back(d_generators.back().get());
+	}
 
-					lcp_interval = {
-							k - 1,				// pos
-							buffer[i].lcp,		// lcp value
-					};
-					stacked_list.push_front(lcp_interval);
-					// cout << stacked_list.size() << endl;
-					top_lcp = buffer[i].lcp;
-
-				} else if (buffer[i].lcp < top_lcp) {
-
-					LetterNumber ini_pos = i - 1;
-					while(!stacked_list.empty() && buffer[i].lcp < top_lcp) {
-						ini_pos = stacked_list.front().pos;
-						stacked_list.pop_front();
-						// cout << stacked_list.size() << endl;
-						if(!stacked_list.empty())
-							top_lcp = stacked_list.front().lcp;
-						else
-							top_lcp = 0;
-					}
-
-					if(buffer[i].lcp > max_common_lcp) {
-
-						if(buffer[i].lcp > top_lcp) {
-
-							lcp_interval = {
-									ini_pos,			// pos
-									buffer[i].lcp,	// lcp value
-							};
-							stacked_list.push_front(lcp_interval);
-							// cout << stacked_list.size() << endl;
-						}
-					}
-					else {
-						max_common_lcp = buffer[i].lcp;
-					}
-					top_lcp = buffer[i].lcp;
+	const LetterNumber n = gesa_reader.getLength();
+	const unsigned int T = chunkWorkers(params, n);
+	if(T > 1) {
+		generateDChunks(f_ESA, n, T, chunked_generators);
+	}
+	else {
+		const t_GSA* block;
+		LetterNumber block_length;
+		while((block_length = gesa_reader.nextSpan(block, BUFFER_SIZE)) > 0) {
+			for(auto &d_generator : d_generators)
+				for(LetterNumber b = 0; b < block_length; ++b)
+					d_generator->processGESAStruct(block[b]);
+			MemoryGovernor::checkCeiling(C_StackedDGenerator_ClassName, __func__);
+		}
+	}
 
-				}
+	for(auto &d_generator : d_generators)
+		d_generator->endD();
 
-				if(successive_color != current_color) {
-					while(!stacked_list.empty()) {
-						stackedLCPInterval wr_lcp_interval = stacked_list.back();
-						stacked_list.pop_back();
-						// cout << "D[" << wr_lcp_interval.pos <<
-						//		"] = " << wr_lcp_interval.lcp + 1 << endl;
-						// cout << stacked_list.size() << endl;
-						fwrite(&wr_lcp_interval, sizeof(lcp_interval), 1, d_file);
-						max_common_lcp = wr_lcp_interval.lcp;
-					}
-					current_color = successive_color;
-				}
+	fclose(f_ESA);
+}
 
-			} else {
+/* The n suffixes are split in T equal chunks, each processed by its own
+ * generator. The first one starts from the initial state, the others from
+ * an empty stack, recording the state before their first suffixes met
+ * with an empty stack. Then, in order, the generator holding the exact
+ * state at the end of a chunk continues over the following one until its
+ * stack is empty in a recorded state of that chunk: from there on the two
+ * generators are the same, and the intervals of the chunk are exact. If no
+ * state matches the chunk is recomputed entirely.
+ * The D file is the sequence of the exact intervals of every generator,
+ * in the order they were written, as in the sequential generation.
+ * Every worker processes its chunk for all the references at once, each
+ * block of the target GESA read once for all of them.
+ */
+void StackedDGenerator::generateDChunks(FILE* f_ESA, const LetterNumber n, const unsigned int T,
+		const vector<StackedDGenerator*> &d_generators) {
+
+	// chunks[c][j] is the c-th chunk of the j-th generator; the first
+	// chunks start from the exact state and record no snapshot
+	vector<vector<unique_ptr<StackedDGenerator>>> chunks(T);
+	vector<thread> workers;
+	const LetterNumber max_snapshots = max(C_MaxDSnapshots/d_generators.size(), (LetterNumber) 1);
+	for(unsigned int c = 0; c < T; ++c) {
+		for(StackedDGenerator* d_generator : d_generators) {
+			chunks[c].push_back(unique_ptr<StackedDGenerator>(
+					new StackedDGenerator(d_generator->params, d_generator->reference_color, c + 1)));
+			chunks[c].back()->beginChunkD((n*c)/T,
+					c > 0 ? min(max_snapshots, (n*(c + 1))/T - (n*c)/T) : 0);
+		}
+		workers.push_back(thread(&StackedDGenerator::processChunk,
+				f_ESA, (n*c)/T, (n*(c + 1))/T, ref(chunks[c])));
+	}
+	for(thread &worker : workers)
+		worker.join();
+
+	for(size_t j = 0; j < d_generators.size(); ++j) {
+		vector<StackedDGenerator*> reference_chunks;
+		for(unsigned int c = 0; c < T; ++c)
+			reference_chunks.push_back(chunks[c][j].get());
+		d_generators[j]->joinChunks(f_ESA, n, reference_chunks);
+	}
+}
 
-				while(!stacked_list.empty()) {
-					stacked_list.pop_front();
-					// cout << stacked_list.size() << endl;
-				}
-				current_color = successive_color;
-				max_common_lcp = 0;
-				top_lcp = 0;
+// Chunks shorter than a buffer are not worth a thread
+unsigned int StackedDGenerator::chunkWorkers(MultiACSParameters* params, const LetterNumber n) {
+	return min((LetterNumber) params->threads, max(n/BUFFER_SIZE, (LetterNumber) 1));
+}
 
+void StackedDGenerator::joinChunks(FILE* f_ESA, const LetterNumber n, const vector<StackedDGenerator*> &chunks) {
+
+	const unsigned int T = chunks.size();
+	// Intervals of generator c written in time from[c]..to[c]-1 are exact
+	vector<LetterNumber> from(T, n), to(T, n);
+	from[0] = 0;
+	unsigned int exact = 0;
+	for(unsigned int c = 1; c < T; ++c) {
+		const LetterNumber last = (n*(c + 1))/T;
+		GESAReader gesa_reader(f_ESA, (n*c)/T);
+		LetterNumber pos = (n*c)/T;
+		bool matched = false;
+		const t_GSA* block;
+		LetterNumber block_length;
+		while(!matched && pos < last
+				&& (block_length = gesa_reader.nextSpan(block, min(last - pos, (LetterNumber) BUFFER_SIZE))) > 0) {
+			for(LetterNumber b = 0; b < block_length; ++b, ++pos) {
+				if(chunks[c]->matchesSnapshot(*chunks[exact], pos)) {
+					matched = true;
+					break;
+				}
+				chunks[exact]->processGESAStruct(block[b]);
 			}
-
 		}
-
+		if(matched) {
+			to[exact] = pos;
+			from[c] = pos;
+			exact = c;
+		}
 	}
 
-	fclose(f_ESA);
-	fclose(d_file);
-
-	cout << "D Computation End\n";
-	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
-
-	elapsed = (clock()-start)/(double)(CLOCKS_PER_SEC);
-	elapsed_wc = difftime(time(NULL),start_wc);
+	for(unsigned int c = 0; c < T; ++c) {
+		chunks[c]->copyChunkPairs(*d_writer, last_pos, from[c], to[c]);
+		if(max_stack_size < chunks[c]->max_stack_size)
+			max_stack_size = chunks[c]->max_stack_size;
+	}
+	k = chunks[exact]->k;
+	started = chunks[exact]->started;
+}
 
-	cout << "### D Computation Reporting ###\n";
-	cout << "Elapsed time: " << elapsed << " secs\n";
-	cout << "Wall Clock time: " << elapsed_wc << " secs\n";
-	cout << "Peak memory: " << malloc_count_peak() << " bytes\n";
-	cout << endl;
+void StackedDGenerator::beginChunkD(const LetterNumber first, const LetterNumber max_snapshots) {
+	chunk_file = fopen(chunk_file_name.c_str(), "w+b");
+	if(chunk_file == nullptr) {
+		std::ostringstream err_message;
+		err_message << "Couldn't open file " << chunk_file_name;
+		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+	}
+	resetD();
+	k = first;
+	// Any state is a guess, but the first chunk starts from the initial one
+	started = (first > 0);
+	this->max_snapshots = max_snapshots;
+	snapshots.reserve(max_snapshots);
+}
 
+void StackedDGenerator::processChunk(FILE* f_ESA, const LetterNumber first, const LetterNumber last,
+		vector<unique_ptr<StackedDGenerator>> &chunks) {
+	GESAReader gesa_reader(f_ESA, first);
+	LetterNumber pos = first;
+	const t_GSA* block;
+	LetterNumber block_length;
+	while(pos < last
+			&& (block_length = gesa_reader.nextSpan(block, min(last - pos, (LetterNumber) BUFFER_SIZE))) > 0) {
+		for(auto &chunk : chunks) {
+			for(LetterNumber b = 0; b < block_length; ++b) {
+				if(chunk->stacked_list.empty() && chunk->snapshots.size() < chunk->max_snapshots)
+					chunk->snapshots.push_back({chunk->k, chunk->top_lcp, chunk->max_common_lcp,
+							chunk->current_color, chunk->started});
+				chunk->processGESAStruct(block[b]);
+			}
+		}
+		pos += block_length;
+		MemoryGovernor::checkCeiling(C_StackedDGenerator_ClassName, __func__);
+	}
 }
 
-void StackedDGenerator::generateD() {
+// Whether d_generator is in the state recorded before the suffix pos
+bool StackedDGenerator::matchesSnapshot(const StackedDGenerator &d_generator, const LetterNumber pos) {
+	while(next_snapshot < snapshots.size() && snapshots[next_snapshot].k < pos)
+		++next_snapshot;
+	if(next_snapshot == snapshots.size() || snapshots[next_snapshot].k != pos
+			|| !d_generator.stacked_list.empty())
+		return false;
+	const DStateSnapshot &snapshot = snapshots[next_snapshot];
+	return snapshot.top_lcp == d_generator.top_lcp
+			&& snapshot.max_common_lcp == d_generator.max_common_lcp
+			&& snapshot.current_color == d_generator.current_color
+			&& snapshot.started == d_generator.started;
+}
 
-	std::string input_file_name = params->target_collection_file_name + C_GESAExt;
-	FILE* f_ESA = fopen(input_file_name.c_str(), "rb");
-	if(f_ESA == nullptr) {
-		std::ostringstream err_message;
-		err_message << "Couldn't open file " << input_file_name;
-		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
+// The intervals of a chunk written in time from..to-1 go to the D file of
+// the generator that owns it
+void StackedDGenerator::copyChunkPairs(LCPWriter &writer, LetterNumber &writer_pos,
+		const LetterNumber from, const LetterNumber to) {
+	if(from >= to)
+		return;
+	fflush(chunk_file);
+	rewind(chunk_file);
+	vector<DPairRecord> records(BUFFER_SIZE);
+	size_t count;
+	while((count = fread(records.data(), sizeof(DPairRecord), BUFFER_SIZE, chunk_file)) > 0) {
+		for(size_t i = 0; i < count; ++i) {
+			if(records[i].time >= to)
+				return;
+			if(records[i].time >= from) {
+				writer.writeLCPPair(records[i].lcp_interval, writer_pos);
+				writer_pos = records[i].lcp_interval.pos;
+			}
+		}
+		MemoryGovernor::checkCeiling(C_StackedDGenerator_ClassName, __func__);
 	}
-//	std::cout << "Read from EGSA File: " << input_file_name << std::endl;
-	GESAReader gesa_reader(f_ESA);
+}
+
+void StackedDGenerator::beginD() {
 
-	std::string d_file_name = params->output_file_name + C_DynBlockFileExt;
-	FILE* d_file = fopen(d_file_name.c_str(), "wb");
+	std::string d_file_name = params->workingFileName(reference_color) + C_DynBlockFileExt;
+	d_file = fopen(d_file_name.c_str(), "wb");
 	if(d_file == nullptr) {
 		std::ostringstream err_message;
 		err_message << "Couldn't open file " << d_file_name;
 		Error::stopWithError(C_StackedDGenerator_ClassName, __func__, err_message.str());
 	}
 //	std::cout << "Write to D File: " << d_file_name << std::endl;
-	LCPWriter d_writer(d_file);
+	d_writer.reset(new LCPWriter(d_file));
 
-	list<stackedLCPInterval> stacked_list;
-	stackedLCPInterval lcp_interval, wr_lcp_interval;
-	LetterNumber k = 0, last_pos = 0;
-	SequenceLength top_lcp = 0, max_common_lcp = 0, max_stack_size = 0;
-	bool current_color, successive_color;
-	t_GSA gesa_struct;
+	resetD();
 
-	clock_t start = clock();
-	time_t start_wc = time(NULL);
-	double elapsed, elapsed_wc;
+	start = clock();
+	start_wc = time(NULL);
 
 	cout << "D Computation Starting\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
+}
 
-	while(gesa_reader.readGESAStruct(gesa_struct) && gesa_struct.lcp == 0){
-
-		// cout << "LCP: " << gesa_struct.lcp << "\tID: " << gesa_struct.text << endl;
+void StackedDGenerator::beginInlineD() {
+	d_writer.reset();
+	d_pairs.clear();
+	resetD();
+}
 
-		++k;
-	}
+void StackedDGenerator::resetD() {
+	stacked_list.clear();
+	k = 0;
+	last_pos = 0;
+	top_lcp = 0;
+	max_common_lcp = 0;
+	max_stack_size = 0;
+	started = false;
+	ended = false;
+}
 
-	// cout << "LCP: " << gesa_struct.lcp << "\tID: " << gesa_struct.text << endl;
+void StackedDGenerator::processGESAStruct(const t_GSA &gesa_struct) {
+	processSuffix(gesa_struct.text, gesa_struct.lcp);
+}
 
-	lcp_interval = {
-			k - 1,					// pos
-			gesa_struct.lcp,		// lcp value
-	};
-	stacked_list.push_front(lcp_interval);
-	if(max_stack_size < stacked_list.size())
-		max_stack_size = stacked_list.size();
-	// cout << stacked_list.size() << endl;
-	top_lcp = gesa_struct.lcp;
-	current_color = mapColor(gesa_struct.text);
-	++k;
+void StackedDGenerator::processSuffix(const SequenceNumber id, const SequenceLength lcp) {
 
-	while(gesa_reader.readGESAStruct(gesa_struct)) {
+	stackedLCPInterval lcp_interval, wr_lcp_interval;
 
-		// cout << "LCP: " << gesa_struct.lcp << "\tID: " << gesa_struct.text << endl;
+	// cout << "LCP: " << lcp << "\tID: " << id << endl;
+
+	// The interval stack starts at the first non-zero lcp
+	if(!started) {
+		if(lcp != 0) {
+			lcp_interval = {
+					k - 1,					// pos
+					lcp,			// lcp value
+			};
+			stacked_list.push_front(lcp_interval);
+			if(max_stack_size < stacked_list.size())
+				max_stack_size = stacked_list.size();
+			// cout << stacked_list.size() << endl;
+			top_lcp = lcp;
+			current_color = mapColor(id);
+			started = true;
+		}
+		++k;
+		return;
+	}
 
-		successive_color = mapColor(gesa_struct.text);
+	const bool successive_color = mapColor(id);
 
-		if(gesa_struct.lcp != 0) {
+	if(lcp != 0) {
 
-			if(gesa_struct.lcp > top_lcp) {
+		if(lcp > top_lcp) {
 
-				lcp_interval = {
-						k - 1,					// pos
-						gesa_struct.lcp,		// lcp value
-				};
-				stacked_list.push_front(lcp_interval);
-				if(max_stack_size < stacked_list.size())
-					max_stack_size = stacked_list.size();
-				// cout << stacked_list.size() << endl;
-				top_lcp = gesa_struct.lcp;
+			lcp_interval = {
+					k - 1,					// pos
+					lcp,			// lcp value
+			};
+			stacked_list.push_front(lcp_interval);
+			if(max_stack_size < stacked_list.size())
+				max_stack_size = stacked_list.size();
+			// cout << stacked_list.size() << endl;
+			top_lcp = lcp;
 
-			} else if (gesa_struct.lcp < top_lcp) {
+		} else if (lcp < top_lcp) {
 
-				LetterNumber ini_pos = k - 1;
-				while(!stacked_list.empty() && gesa_struct.lcp < top_lcp) {
-					ini_pos = stacked_list.front().pos;
-					stacked_list.pop_front();
-					// cout << stacked_list.size() << endl;
-					if(!stacked_list.empty())
-						top_lcp = stacked_list.front().lcp;
-					else
-						top_lcp = 0;
-				}
+			LetterNumber ini_pos = k - 1;
+			while(!stacked_list.empty() && lcp < top_lcp) {
+				ini_pos = stacked_list.front().pos;
+				stacked_list.pop_front();
+				// cout << stacked_list.size() << endl;
+				if(!stacked_list.empty())
+					top_lcp = stacked_list.front().lcp;
+				else
+					top_lcp = 0;
+			}
 
-				if(gesa_struct.lcp > max_common_lcp) {
+			if(lcp > max_common_lcp) {
 
-					if(gesa_struct.lcp > top_lcp) {
+				if(lcp > top_lcp) {
 
-						lcp_interval = {
-								ini_pos,			// pos
-								gesa_struct.lcp,	// lcp value
-						};
-						stacked_list.push_front(lcp_interval);
-						if(max_stack_size < stacked_list.size())
-							max_stack_size = stacked_list.size();
-						// cout << stacked_list.size() << endl;
-					}
-				}
-				else {
-					max_common_lcp = gesa_struct.lcp;
+					lcp_interval = {
+							ini_pos,			// pos
+							lcp,		// lcp value
+					};
+					stacked_list.push_front(lcp_interval);
+					if(max_stack_size < stacked_list.size())
+						max_stack_size = stacked_list.size();
+					// cout << stacked_list.size() << endl;
 				}
-				top_lcp = gesa_struct.lcp;
-
 			}
-
-			if(successive_color != current_color) {
-				while(!stacked_list.empty()) {
-					wr_lcp_interval = stacked_list.back();
-					stacked_list.pop_back();
-//					cout << "D[" << wr_lcp_interval.pos <<
-//							"] = " << wr_lcp_interval.lcp + 1 << endl;
-//					 cout << stacked_list.size() << endl;
-					d_writer.writeLCPPair(wr_lcp_interval, last_pos);
-					last_pos = wr_lcp_interval.pos;
-					max_common_lcp = wr_lcp_interval.lcp;
-				}
-				current_color = successive_color;
+			else {
+				max_common_lcp = lcp;
 			}
+			top_lcp = lcp;
 
-		} else {
+		}
 
+		if(successive_color != current_color) {
 			while(!stacked_list.empty()) {
-				stacked_list.pop_front();
-				// cout << stacked_list.size() << endl;
+				wr_lcp_interval = stacked_list.back();
+				stacked_list.pop_back();
+//				cout << "D[" << wr_lcp_interval.pos <<
+//						"] = " << wr_lcp_interval.lcp + 1 << endl;
+//				 cout << stacked_list.size() << endl;
+				writeDPair(wr_lcp_interval);
+				last_pos = wr_lcp_interval.pos;
+				max_common_lcp = wr_lcp_interval.lcp;
 			}
 			current_color = successive_color;
-			max_common_lcp = 0;
-			top_lcp = 0;
-
 		}
-		++k;
+
+	} else {
+
+		stacked_list.clear();
+		current_color = successive_color;
+		max_common_lcp = 0;
+		top_lcp = 0;
 
 	}
-	d_writer.fillWithZeros(k - 1 - last_pos);
-	d_writer.flushLCPValues();
+	++k;
+}
+
+void StackedDGenerator::endD() {
+
+	// Without non-zero lcp values the first suffix is counted once more
+	if(!started)
+		++k;
+	ended = true;
+	if(!d_writer)
+		return;
+
+	d_writer->fillWithZeros(k - 1 - last_pos);
+	d_writer->flushLCPValues();
+	d_writer.reset();
 
-	fclose(f_ESA);
 	fclose(d_file);
+	d_file = nullptr;
 
 	cout << "D Computation End\n";
 	cout << "Current memory: " << malloc_count_current() << " bytes" << endl;
 
-	elapsed = (clock()-start)/(double)(CLOCKS_PER_SEC);
-	elapsed_wc = difftime(time(NULL),start_wc);
+	double elapsed = (clock()-start)/(double)(CLOCKS_PER_SEC);
+	double elapsed_wc = difftime(time(NULL),start_wc);
 
 	cout << "### D Computation Reporting ###\n";
 	cout << "Elapsed time: " << elapsed << " secs\n";
@@ -442,4 +593,97 @@ void StackedDGenerator::generateD() {
 
 }
 
+void StackedDGenerator::writeDPair(const stackedLCPInterval &lcp_interval) {
+	if(d_writer) {
+		d_writer->writeLCPPair(lcp_interval, last_pos);
+	}
+	else if(chunk_file != nullptr) {
+		const DPairRecord record{k, lcp_interval};
+		fwrite(&record, sizeof(DPairRecord), 1, chunk_file);
+	}
+	else {
+		d_pairs.push_back(lcp_interval);
+	}
+}
+
+// Intervals are pushed at the position preceding the current suffix, or at
+// the position of an interval still on the stack, whose bottom holds the
+// smallest one: D is final before both
+LetterNumber StackedDGenerator::getFinalPositions() const {
+	if(ended)
+		return k;
+	LetterNumber final_positions = (k > 0) ? k - 1 : 0;
+	if(!stacked_list.empty() && stacked_list.back().pos < final_positions)
+		final_positions = stacked_list.back().pos;
+	return final_positions;
+}
+
+SequenceLength StackedDGenerator::readDValue(const LetterNumber pos) {
+	while(!d_pairs.empty() && d_pairs.front().pos < pos)
+		d_pairs.pop_front();
+	if(d_pairs.empty() || d_pairs.front().pos != pos)
+		return 0;
+	const SequenceLength d_value = d_pairs.front().lcp + 1;
+	d_pairs.pop_front();
+	return d_value;
+}
+
+InlineDGenerator::InlineDGenerator(MultiACSParameters* params,
+		const vector<SequenceNumber> &reference_colors,
+		FILE* id_file, const ColumnFile &id_column,
+		FILE* lcp_file, const ColumnFile &lcp_column) :
+	id_reader(id_file, id_column),
+	lcp_reader(lcp_file, lcp_column) {
+
+	for(const SequenceNumber color : reference_colors) {
+		d_generators.push_back(unique_ptr<StackedDGenerator>(new StackedDGenerator(params, color)));
+		d_generators.back()->beginInlineD();
+		buffers.push_back(vector<SequenceLength>(BUFFER_SIZE, 0));
+	}
+}
+
+InlineDGenerator::~InlineDGenerator() {
+
+}
+
+LetterNumber InlineDGenerator::nextSpans(const LetterNumber max_length) {
+
+	const LetterNumber span_length = min(max_length, (LetterNumber) BUFFER_SIZE);
+	LetterNumber i = 0;
+	for(; i < span_length; ++i, ++position) {
+		// The generators run ahead of the reader until D[position] is final
+		// for every reference
+		while(!ended && position >= getFinalPositions())
+			feedSuffix();
+		if(position >= getFinalPositions())
+			break;
+		for(size_t j = 0; j < d_generators.size(); ++j)
+			buffers[j][i] = d_generators[j]->readDValue(position);
+	}
+	return i;
+}
+
+LetterNumber InlineDGenerator::getFinalPositions() const {
+	LetterNumber final_positions = C_MaxLetterNumber;
+	for(const auto &d_generator : d_generators)
+		final_positions = min(final_positions, d_generator->getFinalPositions());
+	return final_positions;
+}
+
+// The following suffix of the target collection, or its end, is given to
+// every generator
+void InlineDGenerator::feedSuffix() {
+	SequenceNumber id;
+	SequenceLength lcp;
+	if(id_reader.readSequenceId(id) && lcp_reader.readLCPValue(lcp)) {
+		for(auto &d_generator : d_generators)
+			d_generator->processSuffix(id, lcp);
+	}
+	else {
+		for(auto &d_generator : d_generators)
+			d_generator->endD();
+		ended = true;
+	}
+}
+
 } /* namespace multi_acs */
@@ -43,22 +43,174 @@
 
 #include "Parameters.h"
 #include "CollectionInfo.h"
+#include "Writer.h"
+#include "Reader.h"
+#include <list>
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <ctime>
 
 namespace multi_acs {
 
 const char C_StackedDGenerator_ClassName[]{"StackedDGeneretor"};
 
+// Stack of the lcp intervals of the D generation, whose front is the top.
+// The intervals are held contiguously; past max_intervals the lower half
+// of them is spilled to spill_file_name, read back when the stack shrinks
+// or drains from the bottom.
+class IntervalStack {
+public:
+	IntervalStack(const std::string &spill_file_name, const AllocableMemory memory);
+	~IntervalStack();
+	bool empty() const { return size() == 0; }
+	LetterNumber size() const { return (disk_top - disk_bottom) + (intervals.size() - bottom); }
+	const stackedLCPInterval& front() const { return intervals.back(); }
+	const stackedLCPInterval& back() const {
+		return (disk_top > disk_bottom) ? disk_buffer[disk_bottom - buffer_first] : intervals[bottom];
+	}
+	void push_front(const stackedLCPInterval &lcp_interval);
+	void pop_front();
+	void pop_back();
+	void clear();
+
+private:
+	void spill();
+	void reload();
+	void readIntervals(const LetterNumber i, stackedLCPInterval* lcp_intervals, const LetterNumber count);
+
+	const std::string spill_file_name;
+	const LetterNumber max_intervals;
+	// Intervals in memory from bottom, the top is the last one
+	std::vector<stackedLCPInterval> intervals;
+	LetterNumber bottom{0};
+	// Intervals spilled to disk, below the ones in memory
+	FILE* spill_file{nullptr};
+	LetterNumber disk_bottom{0};
+	LetterNumber disk_top{0};
+	// Spilled intervals buffer_first..buffer_end-1, read from the bottom
+	std::vector<stackedLCPInterval> disk_buffer;
+	LetterNumber buffer_first{0};
+	LetterNumber buffer_end{0};
+};
+
+// Snapshots of an empty interval stack recorded by each worker of a
+// parallel D generation, shared by the chunks of its references
+const LetterNumber C_MaxDSnapshots{1 << 16};
+
+// Interval written by a chunk of a parallel D generation, while processing
+// the suffix time
+struct DPairRecord {
+	LetterNumber time;
+	stackedLCPInterval lcp_interval;
+};
+
+// State of the D generation before a suffix, when its stack is empty
+struct DStateSnapshot {
+	LetterNumber k;
+	SequenceLength top_lcp;
+	SequenceLength max_common_lcp;
+	bool current_color;
+	bool started;
+};
+
 class StackedDGenerator {
 public:
 	StackedDGenerator(MultiACSParameters* params);
+	StackedDGenerator(MultiACSParameters* params, const SequenceNumber reference_color);
+	// Generator of the chunk-th range of a parallel D generation
+	StackedDGenerator(MultiACSParameters* params, const SequenceNumber reference_color, const unsigned int chunk);
 	virtual ~StackedDGenerator();
-	void generateDPairs();
+	// With several threads the D files are generated by generateDChunks
 	void generateD();
+	static void generateD(MultiACSParameters* params, const std::vector<SequenceNumber> &reference_colors);
+	// Workers of the parallel D generation of n suffixes
+	static unsigned int chunkWorkers(MultiACSParameters* params, const LetterNumber n);
+
+	// D generation fed one GESA record at a time, in the order of the
+	// target collection, so that one scan serves several generators
+	void beginD();
+	void processGESAStruct(const t_GSA &gesa_struct);
+	void processSuffix(const SequenceNumber id, const SequenceLength lcp);
+	void endD();
+
+	// Inline D generation: no .d file is written, the D values are read
+	// back (readDValue) once final, in the order of the suffixes
+	void beginInlineD();
+	// D values of the suffixes before this position are final
+	LetterNumber getFinalPositions() const;
+	SequenceLength readDValue(const LetterNumber pos);
+	bool isEnded() const { return ended; }
 
 	MultiACSParameters* params;
+	const SequenceNumber reference_color;
 
 private:
 	bool mapColor(SequenceNumber id);
+	void resetD();
+	void writeDPair(const stackedLCPInterval &lcp_interval);
+
+	static void generateDChunks(FILE* f_ESA, const LetterNumber n, const unsigned int T,
+			const std::vector<StackedDGenerator*> &d_generators);
+	static void processChunk(FILE* f_ESA, const LetterNumber first, const LetterNumber last,
+			std::vector<std::unique_ptr<StackedDGenerator>> &chunks);
+	void joinChunks(FILE* f_ESA, const LetterNumber n, const std::vector<StackedDGenerator*> &chunks);
+	void beginChunkD(const LetterNumber first, const LetterNumber max_snapshots);
+	bool matchesSnapshot(const StackedDGenerator &d_generator, const LetterNumber pos);
+	void copyChunkPairs(LCPWriter &writer, LetterNumber &writer_pos,
+			const LetterNumber from, const LetterNumber to);
+
+	FILE* d_file{nullptr};
+	std::unique_ptr<LCPWriter> d_writer;
+	IntervalStack stacked_list;
+	LetterNumber k{0};
+	LetterNumber last_pos{0};
+	SequenceLength top_lcp{0};
+	SequenceLength max_common_lcp{0};
+	SequenceLength max_stack_size{0};
+	bool current_color{false};
+	// A non-zero lcp has been met
+	bool started{false};
+	bool ended{false};
+	// Intervals written by inline D generation, not yet read
+	std::deque<stackedLCPInterval> d_pairs;
+	// Intervals and snapshots of a chunk of a parallel D generation
+	const std::string chunk_file_name;
+	FILE* chunk_file{nullptr};
+	std::vector<DStateSnapshot> snapshots;
+	LetterNumber max_snapshots{0};
+	LetterNumber next_snapshot{0};
+	clock_t start{0};
+	time_t start_wc{0};
+};
+
+// D values of several references computed while they are read, by one
+// generator for each reference, all fed with one scan of the id and lcp
+// columns of the target collection
+class InlineDGenerator {
+public:
+	InlineDGenerator(MultiACSParameters* params,
+			const std::vector<SequenceNumber> &reference_colors,
+			FILE* id_file, const ColumnFile &id_column,
+			FILE* lcp_file, const ColumnFile &lcp_column);
+	~InlineDGenerator();
+	// D values of the following suffixes, up to max_length, for every
+	// reference: returns how many, 0 at the end of the collection
+	LetterNumber nextSpans(const LetterNumber max_length);
+	// D values of the j-th reference read by the last call of nextSpans
+	const SequenceLength* getSpan(const SequenceNumber j) const { return buffers[j].data(); }
+
+private:
+	LetterNumber getFinalPositions() const;
+	void feedSuffix();
+
+	std::vector<std::unique_ptr<StackedDGenerator>> d_generators;
+	IdReader id_reader;
+	LCPReader lcp_reader;
+	std::vector<std::vector<SequenceLength>> buffers;
+	LetterNumber position{0};
+	bool ended{false};
 };
 
 } /* namespace multi_acs */
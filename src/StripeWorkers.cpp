@@ -0,0 +1,98 @@
+/**
+ ** This software is covered by the "BSD 2-Clause License"
+ ** and any user of this software or source file is bound by the terms therein.
+ ** 
+ ** Redistribution and use in source and binary forms, with or without
+ ** modification, are permitted provided that the following conditions are met:
+ **
+ ** - Redistributions of source code must retain the above copyright notice, this
+ **   list of conditions and the following disclaimer.
+ **
+ ** - Redistributions in binary form must reproduce the above copyright notice,
+ **   this list of conditions and the following disclaimer in the documentation
+ **   and/or other materials provided with the distribution.
+ **
+ **
+ ** This software is an implementation of the algorithm described in:
+ ** The colored longest common prefix array computed via sequential scans
+ ** SPIRE 2018
+ ** by F. Garofalo, G. Rosone, M. Sciortino and D. Verzotto
+ ** 
+ ** 
+ ** Supported by the project Italian MIUR-SIR CMACBioSeq 
+ ** (``Combinatorial methods for analysis and compression of biological sequences'') 
+ ** grant n.~RBSI146R5L.
+ ** 
+ ** 
+ ** Copyright by the above authors.
+ ** 
+ **
+ ** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ ** AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ ** IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ ** DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ ** FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ ** DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ ** SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ ** CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ ** OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#include "StripeWorkers.h"
+
+using namespace std;
+
+namespace multi_acs {
+
+StripeWorkers::StripeWorkers(const unsigned int T) :
+	T(T > 0 ? T : 1) {
+	for(unsigned int t = 1; t < this->T; ++t)
+		workers.push_back(thread(&StripeWorkers::work, this, t));
+}
+
+StripeWorkers::~StripeWorkers() {
+	{
+		lock_guard<mutex> lock(page_mutex);
+		stopping = true;
+	}
+	page_ready.notify_all();
+	for(thread &worker : workers)
+		worker.join();
+}
+
+void StripeWorkers::run(const function<void(unsigned int)> &stripe_task) {
+	if(T == 1) {
+		stripe_task(0);
+		return;
+	}
+	{
+		lock_guard<mutex> lock(page_mutex);
+		task = &stripe_task;
+		running = T - 1;
+		++pages;
+	}
+	page_ready.notify_all();
+	stripe_task(0);
+	unique_lock<mutex> lock(page_mutex);
+	page_done.wait(lock, [this] { return running == 0; });
+	task = nullptr;
+}
+
+void StripeWorkers::work(const unsigned int t) {
+	LetterNumber page = 0;
+	unique_lock<mutex> lock(page_mutex);
+	while(true) {
+		page_ready.wait(lock, [this, page] { return stopping || pages != page; });
+		if(stopping)
+			return;
+		page = pages;
+		const function<void(unsigned int)>* stripe_task = task;
+		lock.unlock();
+		(*stripe_task)(t);
+		lock.lock();
+		if(--running == 0)
+			page_done.notify_one();
+	}
+}
+
+} /* namespace multi_acs */
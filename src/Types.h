@@ -56,19 +56,44 @@ typedef unsigned char AlphabetSymbol;
 // Type to represent: Dimension of the sequences alphabet
 typedef AlphabetSymbol AlphabetSize;
 
-/* TODO Handle correct size of the type used.
- * - Is it better to provide a macro variable to specify the types dimension at compile time
+/* Widths of lengths and colors, chosen at compile time by MULTI_ACS_LCP_BITS
+ * and MULTI_ACS_COLOR_BITS (16, 32 or 64, 32 by default), e.g.
+ *   make CXXFLAGS="-DMULTI_ACS_LCP_BITS=16 -DMULTI_ACS_COLOR_BITS=16"
+ * The rows of the partial cLCP hold lengths: 16-bit lengths halve them for
+ * collections of sequences shorter than 65535 symbols.
  */
+#ifndef MULTI_ACS_LCP_BITS
+#define MULTI_ACS_LCP_BITS 32
+#endif
+#ifndef MULTI_ACS_COLOR_BITS
+#define MULTI_ACS_COLOR_BITS 32
+#endif
 
 // Type to represent: Length of a sequence / LCP value
+#if MULTI_ACS_LCP_BITS == 16
+typedef uint16_t SequenceLength;
+#elif MULTI_ACS_LCP_BITS == 32
 typedef uint32_t SequenceLength;
-// typedef uint16_t SequenceLength;
+#elif MULTI_ACS_LCP_BITS == 64
+typedef uint64_t SequenceLength;
+#else
+#error "MULTI_ACS_LCP_BITS should be 16, 32 or 64"
+#endif
 
 // Type to represent: Number of sequences
-/* USE: uint32_t - below 4.294.967.296 sequences
+/* USE: uint16_t - below 65.535 sequences
+ *		uint32_t - below 4.294.967.295 sequences
  *		uint64_t - otherwise
  */
+#if MULTI_ACS_COLOR_BITS == 16
+typedef uint16_t SequenceNumber;
+#elif MULTI_ACS_COLOR_BITS == 32
 typedef uint32_t SequenceNumber;
+#elif MULTI_ACS_COLOR_BITS == 64
+typedef uint64_t SequenceNumber;
+#else
+#error "MULTI_ACS_COLOR_BITS should be 16, 32 or 64"
+#endif
 
 // Type to represent: Number of characters in EBWT / SA value (position)
 /* USE: uint32_t - below 4.294.967.296 characters
@@ -102,14 +127,37 @@ struct stackedLCPInterval {
 	SequenceLength lcp;
 };
 
+// Color changed between two consecutive rows of a sparse partial cLCP
+struct CLCPDelta {
+	SequenceNumber color;
+	// Value in the preceding row
+	SequenceLength value;
+};
+
 // eGSA Types
 
-typedef unsigned int int_text;
-typedef unsigned int int_suff;
-typedef unsigned int int_lcp;
+/* Width of the fields of the eGSA records, chosen at compile time by
+ * MULTI_ACS_GESA_BITS (32 by default, 64 for the .gesa of 64-bit eGSA
+ * builds, needed by collections of more than 4 G suffixes).
+ */
+#ifndef MULTI_ACS_GESA_BITS
+#define MULTI_ACS_GESA_BITS 32
+#endif
+
+#if MULTI_ACS_GESA_BITS == 32
+typedef uint32_t int_text;
+typedef uint32_t int_suff;
+typedef uint32_t int_lcp;
+#elif MULTI_ACS_GESA_BITS == 64
+typedef uint64_t int_text;
+typedef uint64_t int_suff;
+typedef uint64_t int_lcp;
+#else
+#error "MULTI_ACS_GESA_BITS should be 32 or 64"
+#endif
 typedef unsigned char int8;
 
-#pragma pack(1)
+#pragma pack(push, 1)
 typedef struct{
 
 	int_text	text;
@@ -118,6 +166,7 @@ typedef struct{
 	int8		bwt;
 
 } t_GSA;
+#pragma pack(pop)
 
 const std::string C_GESAExt{".gesa"};
 
@@ -140,6 +189,12 @@ const std::string C_DynBlockFileExt{".d"};
 const std::string C_ColorFileExt{".z"};
 const std::string C_CLcpFileExt{".clcp"};
 const std::string C_PartialCLcpFileExt{".xclcp"};
+const std::string C_ReferenceLcpFileExt{".xlcp"};
+const std::string C_PartialCLcpIndexFileExt{".xclcpi"};
+const std::string C_CLcpCheckpointFileExt{".xckp"};
+const std::string C_DStackSpillFileExt{".dstk"};
+const std::string C_DChunkFileExt{".dchk"};
+const std::string C_TraceFileExt{".xtrc"};
 const std::string C_DistanceFileExt{".acs"};
 
 const AlphabetSymbol C_MaxAlphabetSize{static_cast<AlphabetSize>(-1)};
@@ -147,6 +202,13 @@ const SequenceNumber C_MaxSequenceNumber{static_cast<SequenceNumber>(-1)};
 const SequenceLength C_MaxSequenceLength{static_cast<SequenceLength>(-1)};
 const LetterNumber C_MaxLetterNumber{static_cast<LetterNumber>(-1)};
 
+// Default memory of the interval stack of the D generation, beyond which
+// its bottom is spilled to disk
+const AllocableMemory C_DefaultDStackMemory{64 << 20};
+
+// Rows of a sparse partial cLCP for each entry of its index
+const SequenceLength C_SparseCLCPBlockRows{256};
+
 
 
 struct UnresolvedBlock {
@@ -42,6 +42,8 @@
 #include "Tools.h"
 #include <unistd.h>
 #include <sstream>
+#include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -413,7 +415,90 @@ void CLCPWriter::flushCLCPValues() {
 	}
 }
 
+SparseCLCPWriter::SparseCLCPWriter(FILE* clcp_file, FILE* index_file, SequenceNumber seq_num) :
+		clcp_file(clcp_file),
+		index_file(index_file),
+		seq_num(seq_num),
+		last_row(seq_num, 0) {
+
+	deltas.reserve(seq_num);
+}
+
+SparseCLCPWriter::~SparseCLCPWriter() {
+
+}
+
+bool SparseCLCPWriter::writeCLCPRows(const SequenceLength *clcp_rows, SequenceLength rows_num) {
+	for(SequenceLength j = 0; j < rows_num; ++j, ++rows_counter) {
+		const SequenceLength* row = clcp_rows + (LetterNumber) j*seq_num;
+		deltas.clear();
+		for(SequenceNumber i = 0; i < seq_num; ++i) {
+			if(row[i] != last_row[i]) {
+				deltas.push_back({i, last_row[i]});
+				last_row[i] = row[i];
+			}
+		}
+		if(rows_counter % C_SparseCLCPBlockRows == 0)
+			fwrite(&clcp_file_offset, sizeof(LetterNumber), 1, index_file);
+		SequenceNumber deltas_num = deltas.size();
+		if((LetterNumber) deltas_num*sizeof(CLCPDelta) < (LetterNumber) seq_num*sizeof(SequenceLength)) {
+			fwrite(&deltas_num, sizeof(SequenceNumber), 1, clcp_file);
+			fwrite(deltas.data(), sizeof(CLCPDelta), deltas_num, clcp_file);
+			clcp_file_offset += sizeof(SequenceNumber) + deltas_num*sizeof(CLCPDelta);
+		}
+		else {
+			// Too many changes: the preceding row is stored as it is
+			for(const CLCPDelta &delta : deltas)
+				last_row[delta.color] = delta.value;
+			deltas_num = C_MaxSequenceNumber;
+			fwrite(&deltas_num, sizeof(SequenceNumber), 1, clcp_file);
+			fwrite(last_row.data(), sizeof(SequenceLength), seq_num, clcp_file);
+			copy(row, row + seq_num, last_row.begin());
+			clcp_file_offset += sizeof(SequenceNumber) + (LetterNumber) seq_num*sizeof(SequenceLength);
+		}
+	}
+	return !ferror(clcp_file) && !ferror(index_file);
+}
+
+void SparseCLCPWriter::flushCLCPRows() {
+	fwrite(last_row.data(), sizeof(SequenceLength), seq_num, index_file);
+}
+
+CLCPCheckpointWriter::CLCPCheckpointWriter(FILE* checkpoint_file, SequenceNumber seq_num, SequenceLength page_rows) :
+		checkpoint_file(checkpoint_file),
+		seq_num(seq_num) {
+
+	fwrite(&page_rows, sizeof(SequenceLength), 1, checkpoint_file);
+}
 
+CLCPCheckpointWriter::~CLCPCheckpointWriter() {
+
+}
+
+void CLCPCheckpointWriter::writeCheckpoint(SequenceLength h, LetterNumber position, const SequenceLength *clcp_row) {
+	fwrite(&h, sizeof(SequenceLength), 1, checkpoint_file);
+	fwrite(&position, sizeof(LetterNumber), 1, checkpoint_file);
+	fwrite(clcp_row, sizeof(SequenceLength), seq_num, checkpoint_file);
 }
 
+void TraceWriter::suffixValue(const SequenceNumber id, const SequenceLength value) {
+	writeRecord(C_TraceSuffixValue, id, value);
+}
 
+void TraceWriter::forwardRow(const SequenceLength h, const SequenceLength *clcp_row, const SequenceNumber m) {
+	writeRecord(C_TraceForwardRow, h, m);
+	fwrite(clcp_row, sizeof(SequenceLength), m, trace_file);
+}
+
+void TraceWriter::backwardRow(const SequenceLength h, const SequenceLength *clcp_row, const SequenceNumber m) {
+	writeRecord(C_TraceBackwardRow, h, m);
+	fwrite(clcp_row, sizeof(SequenceLength), m, trace_file);
+}
+
+void TraceWriter::writeRecord(const char kind, const LetterNumber index, const LetterNumber value) {
+	fwrite(&kind, sizeof(char), 1, trace_file);
+	fwrite(&index, sizeof(LetterNumber), 1, trace_file);
+	fwrite(&value, sizeof(LetterNumber), 1, trace_file);
+}
+
+}
@@ -42,6 +42,7 @@
 #define WRITER_H_
 
 #include "Types.h"
+#include <vector>
 
 namespace multi_acs {
 
@@ -179,6 +180,78 @@ private:
 	LetterNumber clcp_counter{0};
 };
 
+// Rows of a partial cLCP, each one stored as the colors changed with
+// respect to the preceding row: the number of changes followed by the
+// changed colors with their preceding value (or the whole preceding row,
+// when shorter).
+// The index file holds the offset of every block of C_SparseCLCPBlockRows
+// rows, followed by the last row, so that the rows can be rebuilt in
+// reverse order (SparseCLCPReader).
+class SparseCLCPWriter {
+public:
+	SparseCLCPWriter(FILE* clcp_file, FILE* index_file, SequenceNumber seq_num);
+	~SparseCLCPWriter();
+	// False if a write failed
+	bool writeCLCPRows(const SequenceLength *clcp_rows, SequenceLength rows_num);
+	void flushCLCPRows();
+
+private:
+	FILE* clcp_file{nullptr};
+	FILE* index_file{nullptr};
+	SequenceNumber seq_num{1};
+	std::vector<SequenceLength> last_row;
+	std::vector<CLCPDelta> deltas;
+	LetterNumber rows_counter{0};
+	LetterNumber clcp_file_offset{0};
+};
+
+// Checkpoints of a partial cLCP whose rows are not stored: the page size Q,
+// then for every page after the first one the index h of its first row, the
+// position of the suffix following the h-th reference suffix in the target
+// collection and the row h (before the contribution of the following
+// suffixes). A page is recomputed from its checkpoint (CLCPCheckpointReader).
+class CLCPCheckpointWriter {
+public:
+	CLCPCheckpointWriter(FILE* checkpoint_file, SequenceNumber seq_num, SequenceLength page_rows);
+	~CLCPCheckpointWriter();
+	void writeCheckpoint(SequenceLength h, LetterNumber position, const SequenceLength *clcp_row);
+
+private:
+	FILE* checkpoint_file{nullptr};
+	SequenceNumber seq_num{1};
+};
+
+// Trace policies of the cLCP passes. The hot loops are instantiated on
+// NoTrace, which compiles to nothing, and with -v on TraceWriter, which
+// writes binary records {kind, index, value} to a trace file, index and
+// value being 64-bit whatever the widths of the build: the value
+// given to the suffixes of color index ('v'), or the row index of the
+// partial cLCP of the forward ('f') or backward ('b') computation, whose
+// value is m and which is followed by the m values of the row.
+const char C_TraceSuffixValue{'v'};
+const char C_TraceForwardRow{'f'};
+const char C_TraceBackwardRow{'b'};
+
+struct NoTrace {
+	static const bool enabled{false};
+	void suffixValue(const SequenceNumber, const SequenceLength) { }
+	void forwardRow(const SequenceLength, const SequenceLength*, const SequenceNumber) { }
+	void backwardRow(const SequenceLength, const SequenceLength*, const SequenceNumber) { }
+};
+
+class TraceWriter {
+public:
+	static const bool enabled{true};
+	TraceWriter(FILE* trace_file) : trace_file(trace_file) { }
+	void suffixValue(const SequenceNumber id, const SequenceLength value);
+	void forwardRow(const SequenceLength h, const SequenceLength *clcp_row, const SequenceNumber m);
+	void backwardRow(const SequenceLength h, const SequenceLength *clcp_row, const SequenceNumber m);
+
+private:
+	FILE* trace_file{nullptr};
+
+	void writeRecord(const char kind, const LetterNumber index, const LetterNumber value);
+};
 
 } /* namespace multi_acs */
 
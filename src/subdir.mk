@@ -5,29 +5,47 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ./src/CollectionInfo.cpp \
+./src/ForwardScanner.cpp \
 ./src/GESAConverter.cpp \
+./src/MemoryGovernor.cpp \
 ./src/MultiACS.cpp \
+./src/PageArena.cpp \
+./src/Planner.cpp \
 ./src/Parameters.cpp \
 ./src/Reader.cpp \
+./src/RowKernels.cpp \
 ./src/StackedDGenerator.cpp \
+./src/StripeWorkers.cpp \
 ./src/Writer.cpp 
 
 OBJS += \
 ./src/CollectionInfo.o \
+./src/ForwardScanner.o \
 ./src/GESAConverter.o \
+./src/MemoryGovernor.o \
 ./src/MultiACS.o \
+./src/PageArena.o \
+./src/Planner.o \
 ./src/Parameters.o \
 ./src/Reader.o \
+./src/RowKernels.o \
 ./src/StackedDGenerator.o \
+./src/StripeWorkers.o \
 ./src/Writer.o 
 
 CPP_DEPS += \
 ./src/CollectionInfo.d \
+./src/ForwardScanner.d \
 ./src/GESAConverter.d \
+./src/MemoryGovernor.d \
 ./src/MultiACS.d \
+./src/PageArena.d \
+./src/Planner.d \
 ./src/Parameters.d \
 ./src/Reader.d \
+./src/RowKernels.d \
 ./src/StackedDGenerator.d \
+./src/StripeWorkers.d \
 ./src/Writer.d 
 
 
@@ -35,7 +53,7 @@ CPP_DEPS += \
 src/%.o: ./src/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C++ Compiler'
-	g++ -std=c++0x -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	g++ -std=c++0x -O2 -g -Wall -pthread $(CXXFLAGS) -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 